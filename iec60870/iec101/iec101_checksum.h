@@ -0,0 +1,101 @@
+#ifndef IEC101_CHECKSUM_H
+#define IEC101_CHECKSUM_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iec_simd.h"
+
+namespace QIEC60870 {
+namespace p101 {
+namespace detail {
+
+inline uint8_t checksumScalar(const uint8_t *data, size_t size, uint8_t seed) {
+  uint8_t cs = seed;
+  for (size_t i = 0; i < size; ++i) {
+    cs += data[i];
+  }
+  return cs;
+}
+
+#ifdef QIEC60870_HAS_SSE2
+/**
+ * @brief psadbw against zero adds up 8 bytes into each 64 bit lane,
+ * only the low 8 bits of the total matter
+ */
+inline uint8_t checksumSse2(const uint8_t *data, size_t size, uint8_t seed) {
+  const __m128i zero = _mm_setzero_si128();
+  __m128i acc = zero;
+  size_t i = 0;
+  for (; i + 16 <= size; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+    acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+  }
+  acc = _mm_add_epi64(acc, _mm_unpackhi_epi64(acc, acc));
+  uint8_t cs = seed + static_cast<uint8_t>(_mm_cvtsi128_si32(acc));
+  return checksumScalar(data + i, size - i, cs);
+}
+#endif
+
+#ifdef QIEC60870_HAS_AVX2_TARGET
+__attribute__((target("avx2"))) inline uint8_t
+checksumAvx2(const uint8_t *data, size_t size, uint8_t seed) {
+  const __m256i zero = _mm256_setzero_si256();
+  __m256i acc = zero;
+  size_t i = 0;
+  for (; i + 32 <= size; i += 32) {
+    __m256i v =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+    acc = _mm256_add_epi64(acc, _mm256_sad_epu8(v, zero));
+  }
+  __m128i sum = _mm_add_epi64(_mm256_castsi256_si128(acc),
+                              _mm256_extracti128_si256(acc, 1));
+  sum = _mm_add_epi64(sum, _mm_unpackhi_epi64(sum, sum));
+  uint8_t cs = seed + static_cast<uint8_t>(_mm_cvtsi128_si32(sum));
+  return checksumSse2(data + i, size - i, cs);
+}
+#endif
+
+typedef uint8_t (*ChecksumFunc)(const uint8_t *, size_t, uint8_t);
+
+/**
+ * @brief the widest implementation the cpu supports, picked once
+ *
+ * @return
+ */
+inline ChecksumFunc bestChecksum() {
+#if defined(QIEC60870_HAS_AVX2_TARGET)
+  if (__builtin_cpu_supports("avx2")) {
+    return checksumAvx2;
+  }
+#endif
+#if defined(QIEC60870_HAS_SSE2)
+  return checksumSse2;
+#else
+  return checksumScalar;
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 8 bit arithmetic sum of data, added to seed,
+ * the FT1.2 frame checksum over C, A and the asdu
+ *
+ * @param data
+ * @param size
+ * @param seed
+ * @return
+ */
+inline uint8_t checksum(const uint8_t *data, size_t size, uint8_t seed = 0) {
+  if (size < 16) {
+    return detail::checksumScalar(data, size, seed);
+  }
+  static const detail::ChecksumFunc func = detail::bestChecksum();
+  return func(data, size, seed);
+}
+
+} // namespace p101
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,45 @@
+#include "iec101_checksum.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p101;
+
+namespace {
+std::vector<uint8_t> makeData(size_t size) {
+  std::vector<uint8_t> data(size);
+  uint32_t x = 0x12345678;
+  for (auto &ch : data) {
+    x = x * 1103515245 + 12345;
+    ch = static_cast<uint8_t>(x >> 16);
+  }
+  return data;
+}
+} // namespace
+
+TEST(Checksum, known_value) {
+  std::vector<uint8_t> data = {0x08, 0x01, 0x46, 0x01, 0x04,
+                               0x01, 0x00, 0x00, 0x00};
+  EXPECT_EQ(checksum(data.data(), data.size()), 0x55);
+  EXPECT_EQ(checksum(data.data() + 2, data.size() - 2, 0x09), 0x55);
+}
+
+TEST(Checksum, implementations_agree) {
+  for (size_t size = 0; size < 300; ++size) {
+    auto data = makeData(size);
+    uint8_t expected = detail::checksumScalar(data.data(), size, 0x5a);
+    EXPECT_EQ(checksum(data.data(), size, 0x5a), expected) << size;
+#ifdef QIEC60870_HAS_SSE2
+    EXPECT_EQ(detail::checksumSse2(data.data(), size, 0x5a), expected) << size;
+#endif
+#ifdef QIEC60870_HAS_AVX2_TARGET
+    if (__builtin_cpu_supports("avx2")) {
+      EXPECT_EQ(detail::checksumAvx2(data.data(), size, 0x5a), expected)
+          << size;
+    }
+#endif
+  }
+}
@@ -0,0 +1,198 @@
+#ifndef IEC101_CONTROL_FIELD_H
+#define IEC101_CONTROL_FIELD_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "iec101_link_layer_frame.h"
+#include "iec_index_sequence.h"
+
+namespace QIEC60870 {
+namespace p101 {
+
+/**
+ * @brief constexpr counterpart of the LinkLayerFrame control setters,
+ * a control field known at compile time costs nothing at runtime.
+ *
+ *   constexpr uint8_t kPoll = ControlField::request(
+ *       StartupFunction::kRequestLevel2UserData).fcb(FCB::k1);
+ */
+class ControlField {
+public:
+  constexpr ControlField() : c_(0) {}
+  constexpr explicit ControlField(uint8_t c) : c_(c) {}
+
+  /**
+   * @brief PRM set, FCV set for the functions that use the FCB
+   *
+   * @param fc
+   * @return
+   */
+  static constexpr ControlField request(StartupFunction fc) {
+    return ControlField(static_cast<uint8_t>(
+        0x40 | (usesFcb(fc) ? 0x10 : 0x00) | static_cast<int>(fc)));
+  }
+  /**
+   * @brief PRM cleared
+   *
+   * @param fc
+   * @return
+   */
+  static constexpr ControlField response(SlaveFunction fc) {
+    return ControlField(static_cast<uint8_t>(static_cast<int>(fc)));
+  }
+  /**
+   * @brief send/confirm user data, test link, and the class 1/2 requests
+   * are the functions that toggle FCB
+   *
+   * @param fc
+   * @return
+   */
+  static constexpr bool usesFcb(StartupFunction fc) {
+    return fc == StartupFunction::kSendLinkStatus ||
+           fc == StartupFunction::kSendUserData ||
+           fc == StartupFunction::kRequestLevel1UserData ||
+           fc == StartupFunction::kRequestLevel2UserData;
+  }
+
+  constexpr ControlField prm(PRM prm) const {
+    return with(0x40, prm == PRM::kFromStartupStation);
+  }
+  constexpr ControlField dir(DIR dir) const {
+    return with(0x80, dir == DIR::kFromSlaveStation);
+  }
+  constexpr ControlField fcb(FCB fcb) const {
+    return with(0x20, fcb == FCB::k1);
+  }
+  constexpr ControlField acd(ACD acd) const {
+    return with(0x20, acd == ACD::kLevel1DataWatingAccess);
+  }
+  constexpr ControlField fcv(FCV fcv) const {
+    return with(0x10, fcv == FCV::kFCBValid);
+  }
+  constexpr ControlField dfc(DFC dfc) const {
+    return with(0x10, dfc == DFC::kSlaveCannotRecv);
+  }
+  /**
+   * @brief fc is StartupFunction/SlaveFunction
+   *
+   * @param fc
+   * @return
+   */
+  constexpr ControlField fc(int fc) const {
+    return ControlField(static_cast<uint8_t>((c_ & 0xf0) | (fc & 0x0f)));
+  }
+
+  constexpr uint8_t value() const { return c_; }
+  constexpr operator uint8_t() const { return c_; }
+
+private:
+  constexpr ControlField with(uint8_t mask, bool set) const {
+    return ControlField(
+        static_cast<uint8_t>((c_ & ~mask) | (set ? mask : 0x00)));
+  }
+
+  uint8_t c_;
+};
+
+/**
+ * @brief a complete fixed frame, 0x10 C A CS 0x16
+ */
+struct FixedFrame {
+  static constexpr size_t kSize = 5;
+  uint8_t bytes[kSize];
+
+  const uint8_t *data() const { return bytes; }
+  constexpr size_t size() const { return kSize; }
+
+  /**
+   * @brief a single memcpy
+   *
+   * @param buf at least kSize bytes
+   * @return kSize
+   */
+  size_t copyTo(uint8_t *buf) const {
+    std::memcpy(buf, bytes, kSize);
+    return kSize;
+  }
+};
+
+constexpr FixedFrame fixedFrame(uint8_t c, uint8_t address) {
+  return FixedFrame{
+      {0x10, c, address, static_cast<uint8_t>(c + address), 0x16}};
+}
+
+namespace detail {
+template <uint8_t C, typename Sequence> struct FixedFrameTableImpl;
+template <uint8_t C, size_t... I>
+struct FixedFrameTableImpl<C, IndexSequence<I...>> {
+  static constexpr FixedFrame kFrames[] = {
+      fixedFrame(C, static_cast<uint8_t>(I))...};
+};
+template <uint8_t C, size_t... I>
+constexpr FixedFrame FixedFrameTableImpl<C, IndexSequence<I...>>::kFrames[];
+} // namespace detail
+
+/**
+ * @brief the fixed frame with control field C for every link address,
+ * built at compile time
+ */
+template <uint8_t C>
+struct FixedFrameTable
+    : detail::FixedFrameTableImpl<C, MakeIndexSequence<256>::type> {
+  static constexpr const FixedFrame &frame(uint8_t address) {
+    return FixedFrameTable::kFrames[address];
+  }
+};
+
+/**
+ * @brief the frames a polling master sends over and over,
+ * from the precomputed tables
+ */
+namespace frames {
+constexpr uint8_t kRequestLinkStatus =
+    ControlField::request(StartupFunction::kRequestLinkStatus);
+constexpr uint8_t kResetRemoteLink =
+    ControlField::request(StartupFunction::kResetRemoteLink);
+constexpr uint8_t kRequestClass1 =
+    ControlField::request(StartupFunction::kRequestLevel1UserData);
+constexpr uint8_t kRequestClass2 =
+    ControlField::request(StartupFunction::kRequestLevel2UserData);
+constexpr uint8_t kAck =
+    ControlField::response(SlaveFunction::kConfirmedRecognized);
+
+inline const FixedFrame &requestLinkStatus(uint8_t address) {
+  return FixedFrameTable<kRequestLinkStatus>::frame(address);
+}
+inline const FixedFrame &resetRemoteLink(uint8_t address) {
+  return FixedFrameTable<kResetRemoteLink>::frame(address);
+}
+inline const FixedFrame &requestClass1(uint8_t address, FCB fcb) {
+  return fcb == FCB::k0
+             ? FixedFrameTable<kRequestClass1>::frame(address)
+             : FixedFrameTable<(kRequestClass1 | 0x20)>::frame(address);
+}
+inline const FixedFrame &requestClass2(uint8_t address, FCB fcb) {
+  return fcb == FCB::k0
+             ? FixedFrameTable<kRequestClass2>::frame(address)
+             : FixedFrameTable<(kRequestClass2 | 0x20)>::frame(address);
+}
+/**
+ * @brief secondary station ack
+ *
+ * @param address
+ * @param acd
+ * @return
+ */
+inline const FixedFrame &ack(uint8_t address, ACD acd) {
+  return acd == ACD::kLevel1NoDataWatingAccess
+             ? FixedFrameTable<kAck>::frame(address)
+             : FixedFrameTable<(kAck | 0x20)>::frame(address);
+}
+} // namespace frames
+
+} // namespace p101
+} // namespace QIEC60870
+
+#endif
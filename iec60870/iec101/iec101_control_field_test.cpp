@@ -0,0 +1,84 @@
+#include "iec101_control_field.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p101;
+
+static_assert(ControlField::request(StartupFunction::kRequestLinkStatus) ==
+                  0x49,
+              "");
+static_assert(ControlField::request(StartupFunction::kRequestLevel2UserData)
+                      .fcb(FCB::k1) == 0x7b,
+              "");
+static_assert(FixedFrameTable<0x5b>::frame(1).bytes[3] == 0x5c, "");
+
+TEST(ControlField, matches_frame_setters) {
+  const int functions[] = {0, 2, 3, 4, 8, 9, 10, 11};
+  for (int fc : functions) {
+    for (FCB fcb : {FCB::k0, FCB::k1}) {
+      LinkLayerFrame frame(0, 1);
+      frame.setPRM(PRM::kFromStartupStation);
+      frame.setFCB(fcb);
+      frame.setFCV(ControlField::usesFcb(static_cast<StartupFunction>(fc))
+                       ? FCV::kFCBValid
+                       : FCV::kFCBInvalid);
+      frame.setFC(fc);
+      EXPECT_EQ(ControlField::request(static_cast<StartupFunction>(fc))
+                    .fcb(fcb)
+                    .value(),
+                frame.ctrlDomain())
+          << fc;
+    }
+  }
+
+  LinkLayerFrame response(0, 1);
+  response.setDIR(DIR::kFromSlaveStation);
+  response.setACD(ACD::kLevel1DataWatingAccess);
+  response.setDFC(DFC::kSlaveCannotRecv);
+  response.setFC(static_cast<int>(SlaveFunction::kResponseUserData));
+  EXPECT_EQ(ControlField::response(SlaveFunction::kResponseUserData)
+                .dir(DIR::kFromSlaveStation)
+                .acd(ACD::kLevel1DataWatingAccess)
+                .dfc(DFC::kSlaveCannotRecv)
+                .value(),
+            response.ctrlDomain());
+  EXPECT_EQ(ControlField(0xff).prm(PRM::kFromSlaveStation).fc(3).value(),
+            0xb3);
+}
+
+TEST(ControlField, fixed_frames_match_encode) {
+  for (int address = 0; address < 256; ++address) {
+    for (FCB fcb : {FCB::k0, FCB::k1}) {
+      const FixedFrame &poll =
+          frames::requestClass2(static_cast<uint8_t>(address), fcb);
+      auto expected =
+          LinkLayerFrame(ControlField::request(
+                             StartupFunction::kRequestLevel2UserData)
+                             .fcb(fcb),
+                         address)
+              .encode();
+      EXPECT_EQ(std::vector<uint8_t>(poll.data(), poll.data() + poll.size()),
+                expected)
+          << address;
+    }
+  }
+
+  uint8_t buf[FixedFrame::kSize];
+  EXPECT_EQ(frames::requestLinkStatus(3).copyTo(buf), 5u);
+  EXPECT_THAT(buf, ElementsAre(0x10, 0x49, 0x03, 0x4c, 0x16));
+  EXPECT_THAT(frames::ack(3, ACD::kLevel1DataWatingAccess).bytes,
+              ElementsAre(0x10, 0x20, 0x03, 0x23, 0x16));
+
+  LinkLayerFrameCodec codec;
+  std::vector<uint8_t> raw(frames::resetRemoteLink(7).bytes,
+                           frames::resetRemoteLink(7).bytes + 5);
+  codec.decode(raw);
+  ASSERT_EQ(codec.error(), FrameParseErr::kNoError);
+  EXPECT_EQ(codec.toLinkLayerFrame().functionCode(),
+            static_cast<int>(StartupFunction::kResetRemoteLink));
+  EXPECT_EQ(codec.toLinkLayerFrame().slaveAddress(), 7);
+}
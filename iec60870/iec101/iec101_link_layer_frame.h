@@ -1,8 +1,15 @@
 #ifndef IEC_APDU_H
 #define IEC_APDU_H
 
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 
+#include "iec101_checksum.h"
+#include "iec_asdu_limits.h"
+
 namespace QIEC60870 {
 namespace p101 {
 enum class FrameParseErr {
@@ -39,19 +46,52 @@ enum class SlaveFunction {
 
 const int kInvalidSlaveAddress = 0x00;
 const int kBroadcastSlaveAddress = 0xffff;
+/**
+ * @brief the longest asdu with a link address of addressSize octets, the
+ * length byte counts C, A and the asdu, and is at most 255
+ *
+ * @param addressSize 0, 1 or 2
+ * @return
+ */
+constexpr size_t maxAsduLength(size_t addressSize) {
+  return maxIec101AsduLength(addressSize);
+}
+/// with the one octet address of LinkLayerFrame::encode()
+const size_t kMaxAsduLength = maxAsduLength(1);
+/// what a LinkLayerFrame holds, the asdu of any link address width
+const size_t kMaxAsduCapacity = maxAsduLength(0);
+/// 0x68 L L 0x68 C A asdu CS 0x16, L at most 255
+const size_t kMaxFrameLength = 255 + 6;
 
 /**
  * @brief Can describe both fixed frames and variable-length frames
- * if asdu_ is empty, it's a fixed frame, otherwise it's a variable frame
+ * if asdu_ is empty, it's a fixed frame, otherwise it's a variable frame.
+ * the asdu is stored inline, so a frame never allocates and is trivially
+ * copyable
  */
 class LinkLayerFrame {
 public:
   LinkLayerFrame() = default;
   ~LinkLayerFrame() = default;
 
-  LinkLayerFrame(uint8_t c, uint16_t a,
-                 const std::vector<uint8_t> &asdu = std::vector<uint8_t>())
-      : C(c), slaveAddress_(a), asdu_(asdu) {}
+  LinkLayerFrame(uint8_t c, uint16_t a) : C(c), slaveAddress_(a) {}
+
+  LinkLayerFrame(uint8_t c, uint16_t a, const std::vector<uint8_t> &asdu)
+      : LinkLayerFrame(c, a, asdu.data(), asdu.size()) {}
+
+  /**
+   * @brief an asdu longer than kMaxAsduCapacity is not stored, overflowed()
+   * tells and the frame is not encoded
+   *
+   * @param c
+   * @param a
+   * @param asdu
+   * @param size
+   */
+  LinkLayerFrame(uint8_t c, uint16_t a, const uint8_t *asdu, size_t size)
+      : C(c), slaveAddress_(a) {
+    setAsdu(asdu, size);
+  }
 
   /**
    * @brief PRM
@@ -135,8 +175,36 @@ public:
     C |= fc;
   }
 
+  /**
+   * @brief
+   *
+   * @param asdu
+   * @param size
+   * @return false if size > kMaxAsduCapacity, the asdu is not stored and
+   * the frame is not encoded until an asdu that fits is set. encode() takes
+   * at most kMaxAsduLength, see LinkLayerFrameEncoder for the other widths
+   */
+  bool setAsdu(const uint8_t *asdu, size_t size) {
+    overflowed_ = size > kMaxAsduCapacity;
+    if (overflowed_) {
+      asduSize_ = 0;
+      return false;
+    }
+    asduSize_ = static_cast<uint8_t>(size);
+    if (asduSize_ != 0) {
+      std::memcpy(asdu_, asdu, asduSize_);
+    }
+    return true;
+  }
+  /**
+   * @brief the last asdu set was too long, see setAsdu()
+   *
+   * @return
+   */
+  bool overflowed() const { return overflowed_; }
+
   void setSlaveLevel12UserDataIsEmpty() {
-    asdu_.clear();
+    asduSize_ = 0;
     isE5Frame_ = true;
   }
   /**
@@ -154,54 +222,201 @@ public:
    *
    * @return
    */
-  bool hasAsdu() { return !asdu_.empty(); }
+  bool hasAsdu() const { return asduSize_ != 0; }
 
-  std::vector<uint8_t> asdu() const { return asdu_; }
+  std::vector<uint8_t> asdu() const {
+    return std::vector<uint8_t>(asdu_, asdu_ + asduSize_);
+  }
+  /**
+   * @brief the inline asdu, without a copy
+   *
+   * @return
+   */
+  const uint8_t *asduData() const { return asdu_; }
+  size_t asduSize() const { return asduSize_; }
   int slaveAddress() const { return slaveAddress_; }
 
-  std::vector<uint8_t> encode() {
-    bool isFixedFrame = asdu_.empty() && !isE5Frame_;
-    std::vector<uint8_t> raw;
+  std::vector<uint8_t> encode() const {
+    std::vector<uint8_t> raw(encodedSize());
+    encode(raw.data(), raw.size());
+    return raw;
+  }
+
+  /**
+   * @brief the number of bytes encode() writes for this frame
+   *
+   * @return 0 if the frame is overflowed() or the asdu is longer than
+   * kMaxAsduLength
+   */
+  size_t encodedSize() const {
+    if (overflowed_ || asduSize_ > kMaxAsduLength) {
+      return 0;
+    }
+    if (isE5Frame_) {
+      return 1;
+    }
+    if (asduSize_ == 0) {
+      return 5;
+    }
+    return 8 + asduSize_;
+  }
+
+  /**
+   * @brief encode into a caller buffer, e.g. a preallocated write buffer
+   * holding several frames
+   *
+   * @param buf
+   * @param size
+   * @return the number of bytes written, 0 if size < encodedSize() or the
+   * frame can not be encoded
+   */
+  size_t encode(uint8_t *buf, size_t size) const {
+    const size_t n = encodedSize();
+    if (n == 0 || size < n) {
+      return 0;
+    }
+    if (isE5Frame_ || asduSize_ == 0) {
+      return encode<uint8_t *>(buf);
+    }
+    uint8_t len = 2 + asduSize_;
+    buf[0] = 0x68;
+    buf[1] = len;
+    buf[2] = len;
+    buf[3] = 0x68;
+    buf[4] = C;
+    buf[5] = static_cast<uint8_t>(slaveAddress_);
+    std::memcpy(buf + 6, asdu_, asduSize_);
+    buf[6 + asduSize_] = checksum(buf + 4, len);
+    buf[7 + asduSize_] = 0x16;
+    return 8 + asduSize_;
+  }
+
+  /**
+   * @brief encode through an output iterator
+   *
+   * @param out
+   * @return the number of bytes written, always encodedSize()
+   */
+  template <typename OutputIt> size_t encode(OutputIt out) const {
+    if (encodedSize() == 0) {
+      return 0;
+    }
+    bool isFixedFrame = asduSize_ == 0 && !isE5Frame_;
     if (isFixedFrame) {
-      raw.push_back(0x10);
-      raw.push_back(C);
-      raw.push_back(static_cast<uint8_t>(slaveAddress_));
-      raw.push_back(C + slaveAddress_); /// cs
-      raw.push_back(0x16);
+      *out++ = 0x10;
+      *out++ = C;
+      *out++ = static_cast<uint8_t>(slaveAddress_);
+      *out++ = static_cast<uint8_t>(C + slaveAddress_); /// cs
+      *out++ = 0x16;
     } else if (isE5Frame_) {
-      raw.push_back(0xe5);
+      *out++ = 0xe5;
     } else {
-      raw.push_back(0x68);
-      uint8_t len = 2 + asdu_.size();
-      raw.push_back(len);
-      raw.push_back(len);
-      raw.push_back(0x68);
-      raw.push_back(C);
-      raw.push_back(static_cast<uint8_t>(slaveAddress_));
-      raw.insert(raw.end(), asdu_.begin(), asdu_.end());
+      uint8_t len = 2 + asduSize_;
+      *out++ = 0x68;
+      *out++ = len;
+      *out++ = len;
+      *out++ = 0x68;
+      *out++ = C;
+      *out++ = static_cast<uint8_t>(slaveAddress_);
       uint8_t cs = C + slaveAddress_;
-      for (const auto &ch : asdu_) {
-        cs += ch;
+      for (size_t i = 0; i < asduSize_; ++i) {
+        *out++ = asdu_[i];
+        cs += asdu_[i];
       }
-      raw.push_back(cs);
-      raw.push_back(0x16);
+      *out++ = cs;
+      *out++ = 0x16;
     }
-    return raw;
+    return encodedSize();
   }
 
 private:
   uint8_t C = 0x00;
   uint16_t slaveAddress_ = kInvalidSlaveAddress;
-  std::vector<uint8_t> asdu_;
   bool isE5Frame_ = false;
+  bool overflowed_ = false;
+  uint8_t asduSize_ = 0;
+  uint8_t asdu_[kMaxAsduCapacity];
 }; // namespace p101
 
-class LinkLayerFrameCodec {
+static_assert(std::is_trivially_copyable<LinkLayerFrame>::value,
+              "LinkLayerFrame is copied around by value on the receive path");
+
+/**
+ * @brief A decoded frame that still lives in the receive buffer,
+ * asdu() points into the raw bytes instead of owning a copy
+ */
+class LinkLayerFrameView {
+public:
+  LinkLayerFrameView() = default;
+
+  LinkLayerFrameView(const uint8_t *raw, size_t rawSize, uint8_t c,
+                     uint16_t a, const uint8_t *asdu = nullptr,
+                     size_t asduSize = 0)
+      : raw_(raw), rawSize_(rawSize), asdu_(asdu), asduSize_(asduSize), C(c),
+        slaveAddress_(a) {}
+
+  /**
+   * @brief E5 frame, the substation has no level 1 and level 2 user data
+   *
+   * @return
+   */
+  bool isSlaveLevel12UserDataEmpty() const { return rawSize_ == 1; }
+  bool hasAsdu() const { return asduSize_ != 0; }
+
+  uint8_t ctrlDomain() const { return C; }
+  int slaveAddress() const { return slaveAddress_; }
+  int functionCode() const { return C & 0x0f; }
+
+  const uint8_t *asdu() const { return asdu_; }
+  size_t asduSize() const { return asduSize_; }
+
+  /**
+   * @brief the whole frame, from the start byte to the end byte
+   *
+   * @return
+   */
+  const uint8_t *raw() const { return raw_; }
+  size_t rawSize() const { return rawSize_; }
+
+  /**
+   * @brief copy the frame out of the receive buffer
+   *
+   * @return
+   */
+  LinkLayerFrame toLinkLayerFrame() const {
+    LinkLayerFrame frame;
+    if (isSlaveLevel12UserDataEmpty()) {
+      frame.setSlaveLevel12UserDataIsEmpty();
+    } else {
+      frame = LinkLayerFrame(C, slaveAddress_, asdu_, asduSize_);
+    }
+    return frame;
+  }
+
+private:
+  const uint8_t *raw_ = nullptr;
+  size_t rawSize_ = 0;
+  const uint8_t *asdu_ = nullptr;
+  size_t asduSize_ = 0;
+  uint8_t C = 0x00;
+  uint16_t slaveAddress_ = kInvalidSlaveAddress;
+};
+
+/**
+ * @brief Decodes FT1.2 frames with a link address of AddressSize octets,
+ * 0, 1 or 2, a system parameter agreed per channel. the width is a template
+ * parameter so that each width gets its own decoder without a runtime
+ * check, LinkLayerFrameCodec is the usual single octet one
+ */
+template <size_t AddressSize> class BasicLinkLayerFrameCodec {
+  static_assert(AddressSize <= 2, "the link address is 0, 1 or 2 octets");
+
   enum State {
     kStart,
     kSecond68,
     kCtrlDomain,
     kAddressOffset0,
+    kAddressOffset1,
     kLengthOffset0,
     kLengthOffset1,
     kAsdu,
@@ -220,129 +435,547 @@ public:
    * @param data
    */
   void decode(const std::vector<uint8_t> &data) {
-    for (const auto &ch : data) {
-      data_.push_back(ch);
-      switch (state_) {
-      case kStart: {
-        if (ch == 0x10) {
-          isFixedFrame_ = true;
-          state_ = kCtrlDomain;
-        } else if (ch == 0x68) {
-          isFixedFrame_ = false;
-          state_ = kLengthOffset0;
-        } else if (ch == 0xe5) {
-          isE5Frame_ = true;
-          isFixedFrame_ = false;
-          err_ = FrameParseErr::kNoError;
-          state_ = kDone;
-        } else {
-          err_ = FrameParseErr::kBadFormat;
-          state_ = kDone;
-        }
-      } break;
-      case kCtrlDomain: {
-        ctrlDomain_ = ch;
-        state_ = kAddressOffset0;
-      } break;
-      case kLengthOffset0: {
-        length_[0] = ch;
-        state_ = kLengthOffset1;
-      } break;
-      case kLengthOffset1: {
-        length_[1] = ch;
-        if (length_[0] != length_[1]) {
-          err_ = FrameParseErr::kCheckError;
-          state_ = kDone;
-        } else {
-          state_ = kSecond68;
+    if (state_ == kDone) {
+      return;
+    }
+    auto keep = [this](const LinkLayerFrameView &view) {
+      frame_ = view.toLinkLayerFrame();
+    };
+    decodeSpan_(data.data(), data.size(), false, keep);
+  }
+
+  /**
+   * @brief decodeStream decode a chunk of a continuous byte stream,
+   * handler is called with a LinkLayerFrameView for every complete frame in
+   * the chunk, the bytes of a trailing incomplete frame are kept and the
+   * frame is completed by the next call, so one codec can serve a channel
+   * for its whole lifetime.
+   * a frame that lies whole in data is viewed in place and stays valid as
+   * long as data does, a frame completed from bytes kept by an earlier call
+   * is viewed in codec storage and is only valid until handler returns.
+   * if a frame is malformed and resync is disabled, decoding stops there and
+   * error() reports why, with resync enabled the codec skips to the next
+   * plausible frame and keeps decoding
+   *
+   * @param data
+   * @param size
+   * @param handler callable as handler(const LinkLayerFrameView &)
+   * @return the number of frames passed to handler
+   */
+  template <typename Handler>
+  size_t decodeStream(const uint8_t *data, size_t size, Handler &&handler) {
+    return decodeSpan_(data, size, true, handler);
+  }
+
+  template <typename Handler>
+  size_t decodeStream(const std::vector<uint8_t> &data, Handler &&handler) {
+    return decodeSpan_(data.data(), data.size(), true, handler);
+  }
+
+  /**
+   * @brief same as above, but every frame is copied out and appended to
+   * frames
+   *
+   * @param data
+   * @param size
+   * @param frames
+   * @return the number of frames appended to frames
+   */
+  size_t decodeStream(const uint8_t *data, size_t size,
+                      std::vector<LinkLayerFrame> &frames) {
+    auto append = [&frames](const LinkLayerFrameView &view) {
+      frames.push_back(view.toLinkLayerFrame());
+    };
+    return decodeSpan_(data, size, true, append);
+  }
+
+  size_t decodeStream(const std::vector<uint8_t> &data,
+                      std::vector<LinkLayerFrame> &frames) {
+    return decodeStream(data.data(), data.size(), frames);
+  }
+
+  /**
+   * @brief if isDone( is true, then can call
+   * error() to check decode is failed or successed,
+   * if decode is successed, the can call toLinkLayerFrame(
+   *
+   * @return
+   */
+  FrameParseErr error() { return err_; }
+
+  /**
+   * @brief with resync enabled, decodeStream() recovers from line garbage:
+   * the start byte of a malformed frame is discarded and the following bytes
+   * are scanned again for the next 0x10/0x68/0xe5 start
+   *
+   * @param enabled
+   */
+  void setResyncEnabled(bool enabled) { resyncEnabled_ = enabled; }
+  bool isResyncEnabled() const { return resyncEnabled_; }
+  /**
+   * @brief number of bytes skipped by resync so far
+   *
+   * @return
+   */
+  uint64_t discardedBytes() const { return discarded_; }
+
+  /**
+   * @brief the frame found by decode()
+   *
+   * @return
+   */
+  LinkLayerFrame toLinkLayerFrame() const { return frame_; }
+
+  /**
+   * @brief forget any partial frame and error, e.g. after the channel
+   * reconnects. settings are kept, counters restart from 0
+   */
+  void reset() {
+    restart_();
+    discarded_ = 0;
+    rawFrameSize_ = 0;
+    frame_ = LinkLayerFrame();
+  }
+
+  /**
+   * @brief for diagnostics, keep a copy of the raw bytes of the last frame,
+   * decoded or malformed, off by default
+   *
+   * @param enabled
+   */
+  void setRawFrameCaptureEnabled(bool enabled) {
+    rawFrameCaptureEnabled_ = enabled;
+    rawFrameSize_ = 0;
+  }
+  bool isRawFrameCaptureEnabled() const { return rawFrameCaptureEnabled_; }
+  /**
+   * @brief the last captured frame, a malformed frame ends at the byte where
+   * decoding failed
+   *
+   * @return
+   */
+  std::vector<uint8_t> lastRawFrame() const {
+    return std::vector<uint8_t>(rawFrame_, rawFrame_ + rawFrameSize_);
+  }
+
+private:
+  /**
+   * @brief decode the frames in data, a frame that is whole in data takes
+   * the decodeWhole_() fast path, otherwise the state machine runs over it
+   * byte by byte, except for the asdu, which is skipped in one step and only
+   * summed up. nothing is copied unless a frame is still incomplete when
+   * data ends
+   *
+   * @param data
+   * @param size
+   * @param stream false to stop after the first frame, as decode() does
+   * @param handler
+   * @return the number of frames passed to handler
+   */
+  template <typename Handler>
+  size_t decodeSpan_(const uint8_t *data, size_t size, bool stream,
+                     Handler &handler) {
+    size_t count = 0;
+    /// where the current frame starts in data, 0 if it started earlier and
+    /// its first bytes are kept in carry_
+    size_t begin = 0;
+    size_t i = 0;
+    while (i < size) {
+      if (state_ == kDone) {
+        if (!stream || err_ != FrameParseErr::kNoError) {
+          return count;
         }
-      } break;
-      case kSecond68: {
-        if (ch != 0x68) {
-          err_ = FrameParseErr::kBadFormat;
-          state_ = kDone;
-        } else {
-          state_ = kCtrlDomain;
+        restart_();
+      }
+      if (state_ == kStart) {
+        begin = i;
+        size_t n = decodeWhole_(data + i, size - i);
+        if (n != 0) {
+          i += n;
+          capture_(data, begin, i);
+          handler(view_(data, begin, i));
+          ++count;
+          continue;
         }
-      } break;
-      case kAddressOffset0: {
-        slaveAddress_ = ch;
-        state_ = isFixedFrame_ ? kCs : kAsdu;
-      } break;
-      case kAsdu: {
-        asdu_.push_back(ch);
-        if (length_[0] == asdu_.size() + 2) {
+      }
+      if (state_ == kAsdu) {
+        size_t n = size - i < asduRemaining_ ? size - i : asduRemaining_;
+        sum_ = checksum(data + i, n, sum_);
+        asduRemaining_ -= n;
+        i += n;
+        if (asduRemaining_ == 0) {
           state_ = kCs;
         }
-      } break;
-      case kCs: {
-        cs_ = ch;
-        state_ = kEnd;
-      } break;
-      case kEnd: {
-        err_ = ch == 0x16 ? FrameParseErr::kNoError : FrameParseErr::kBadFormat;
-        state_ = kDone;
-      } break;
-      case kDone: {
-
-      } break;
+        continue;
       }
 
-      if (state_ == kDone) {
-        break;
+      step_(data[i++]);
+      if (state_ != kDone) {
+        continue;
+      }
+      if (err_ == FrameParseErr::kNoError || carrySize_ + i - begin > 1) {
+        /// a lone byte that is no start byte is not worth keeping
+        capture_(data, begin, i);
+      }
+      if (err_ == FrameParseErr::kNoError) {
+        handler(view_(data, begin, i));
+        ++count;
+      } else if (stream && resyncEnabled_) {
+        /// drop the start byte of the malformed frame and scan the rest again
+        ++discarded_;
+        if (carrySize_ == 0) {
+          i = begin + 1;
+          restart_();
+        } else {
+          size_t replaySize = carrySize_ - 1;
+          std::memcpy(replay_, carry_ + 1, replaySize);
+          restart_();
+          count += decodeSpan_(replay_, replaySize, true, handler);
+          i = 0;
+          begin = 0;
+        }
       }
     }
-    if (err_ == FrameParseErr::kNoError && !isE5Frame_) {
-      uint8_t cs = calculateCs_();
-      if (cs != cs_) {
-        err_ = FrameParseErr::kCheckError;
+    if (state_ != kStart && state_ != kDone) {
+      std::memcpy(carry_ + carrySize_, data + begin, size - begin);
+      carrySize_ += size - begin;
+    }
+    return count;
+  }
+
+  /**
+   * @brief fast path for a frame that is already whole in data,
+   * the header, trailer and checksum are checked without the state machine.
+   * anything unusual, including a malformed frame, is left to the state
+   * machine so that errors and resync behave the same on both paths
+   *
+   * @param data
+   * @param size
+   * @return the frame size, 0 if the frame has to go through the state
+   * machine
+   */
+  size_t decodeWhole_(const uint8_t *data, size_t size) {
+    if (size >= kFixedFrameSize && data[0] == 0x10) {
+      if (data[kFixedFrameSize - 1] != 0x16 ||
+          checksum(data + 1, 1 + AddressSize) != data[kFixedFrameSize - 2]) {
+        return 0;
       }
+      isFixedFrame_ = true;
+      ctrlDomain_ = data[1];
+      slaveAddress_ = readAddress_(data + 2);
+    } else if (size >= kMinVariableFrameSize && data[0] == 0x68) {
+      uint8_t len = data[1];
+      const uint8_t expect[4] = {0x68, len, len, 0x68};
+      uint32_t header;
+      uint32_t expectHeader;
+      std::memcpy(&header, data, 4);
+      std::memcpy(&expectHeader, expect, 4);
+      size_t frameSize = len + 6u;
+      if (header != expectHeader || len < kMinLength || size < frameSize ||
+          data[frameSize - 1] != 0x16 ||
+          checksum(data + 4, len) != data[frameSize - 2]) {
+        return 0;
+      }
+      isFixedFrame_ = false;
+      length_[0] = length_[1] = len;
+      ctrlDomain_ = data[4];
+      slaveAddress_ = readAddress_(data + 5);
+    } else {
+      return 0;
     }
+    err_ = FrameParseErr::kNoError;
+    state_ = kDone;
+    return isFixedFrame_ ? kFixedFrameSize : length_[0] + 6u;
   }
 
   /**
-   * @brief if isDone( is true, then can call
-   * error() to check decode is failed or successed,
-   * if decode is successed, the can call toLinkLayerFrame(
+   * @brief view the frame that ends at data[end]
    *
+   * @param data
+   * @param begin
+   * @param end
    * @return
    */
-  FrameParseErr error() { return err_; }
-  LinkLayerFrame toLinkLayerFrame() const {
-    LinkLayerFrame frame;
+  LinkLayerFrameView view_(const uint8_t *data, size_t begin, size_t end) {
+    const uint8_t *raw = data + begin;
+    size_t rawSize = end - begin;
+    if (carrySize_ != 0) {
+      std::memcpy(carry_ + carrySize_, data, end);
+      carrySize_ += end;
+      raw = carry_;
+      rawSize = carrySize_;
+    }
     if (isE5Frame_) {
-      frame.setSlaveLevel12UserDataIsEmpty();
-    } else if (isFixedFrame_) {
-      frame = LinkLayerFrame(ctrlDomain_, slaveAddress_);
-    } else {
-      frame = LinkLayerFrame(ctrlDomain_, slaveAddress_, asdu_);
+      return LinkLayerFrameView(raw, rawSize, 0x00, kInvalidSlaveAddress);
     }
-    return frame;
+    if (isFixedFrame_) {
+      return LinkLayerFrameView(raw, rawSize, ctrlDomain_, slaveAddress_);
+    }
+    return LinkLayerFrameView(raw, rawSize, ctrlDomain_, slaveAddress_,
+                              raw + 5 + AddressSize,
+                              length_[0] - 1 - AddressSize);
   }
 
-private:
-  uint8_t calculateCs_() {
-    uint8_t cs = 0;
-    cs += ctrlDomain_;
-    cs += slaveAddress_;
-    for (const auto &ch : asdu_) {
-      cs += ch;
+  /**
+   * @brief copy the frame that ends at data[end] for diagnostics
+   *
+   * @param data
+   * @param begin
+   * @param end
+   */
+  void capture_(const uint8_t *data, size_t begin, size_t end) {
+    if (!rawFrameCaptureEnabled_) {
+      return;
+    }
+    std::memcpy(rawFrame_, carry_, carrySize_);
+    std::memcpy(rawFrame_ + carrySize_, data + begin, end - begin);
+    rawFrameSize_ = carrySize_ + end - begin;
+  }
+
+  /**
+   * @brief feed one header or trailer byte into the state machine,
+   * the checksum is verified when the end byte arrives
+   *
+   * @param ch
+   */
+  void step_(uint8_t ch) {
+    switch (state_) {
+    case kStart: {
+      if (ch == 0x10) {
+        isFixedFrame_ = true;
+        state_ = kCtrlDomain;
+      } else if (ch == 0x68) {
+        isFixedFrame_ = false;
+        state_ = kLengthOffset0;
+      } else if (ch == 0xe5) {
+        isE5Frame_ = true;
+        isFixedFrame_ = false;
+        err_ = FrameParseErr::kNoError;
+        state_ = kDone;
+      } else {
+        err_ = FrameParseErr::kBadFormat;
+        state_ = kDone;
+      }
+    } break;
+    case kCtrlDomain: {
+      ctrlDomain_ = ch;
+      sum_ = ch;
+      slaveAddress_ = 0;
+      if (AddressSize == 0) {
+        addressDone_();
+      } else {
+        state_ = kAddressOffset0;
+      }
+    } break;
+    case kLengthOffset0: {
+      length_[0] = ch;
+      state_ = kLengthOffset1;
+    } break;
+    case kLengthOffset1: {
+      length_[1] = ch;
+      if (length_[0] != length_[1]) {
+        err_ = FrameParseErr::kCheckError;
+        state_ = kDone;
+      } else if (length_[0] < kMinLength) {
+        /// C, A and at least one asdu byte
+        err_ = FrameParseErr::kBadFormat;
+        state_ = kDone;
+      } else {
+        state_ = kSecond68;
+      }
+    } break;
+    case kSecond68: {
+      if (ch != 0x68) {
+        err_ = FrameParseErr::kBadFormat;
+        state_ = kDone;
+      } else {
+        state_ = kCtrlDomain;
+      }
+    } break;
+    case kAddressOffset0: {
+      slaveAddress_ = ch;
+      sum_ += ch;
+      if (AddressSize == 2) {
+        state_ = kAddressOffset1;
+      } else {
+        addressDone_();
+      }
+    } break;
+    case kAddressOffset1: {
+      slaveAddress_ = static_cast<uint16_t>(slaveAddress_ | (ch << 8));
+      sum_ += ch;
+      addressDone_();
+    } break;
+    case kAsdu: {
+      /// consumed in bulk by decodeSpan_()
+    } break;
+    case kCs: {
+      cs_ = ch;
+      state_ = kEnd;
+    } break;
+    case kEnd: {
+      if (ch != 0x16) {
+        err_ = FrameParseErr::kBadFormat;
+      } else {
+        err_ = sum_ == cs_ ? FrameParseErr::kNoError
+                           : FrameParseErr::kCheckError;
+      }
+      state_ = kDone;
+    } break;
+    case kDone: {
+
+    } break;
+    }
+  }
+
+  void addressDone_() {
+    if (isFixedFrame_) {
+      state_ = kCs;
+    } else {
+      asduRemaining_ = length_[0] - 1 - AddressSize;
+      state_ = kAsdu;
     }
-    return cs;
+  }
+
+  static uint16_t readAddress_(const uint8_t *data) {
+    return AddressSize == 0   ? 0
+           : AddressSize == 1 ? data[0]
+                              : static_cast<uint16_t>(data[0] | (data[1] << 8));
+  }
+
+  /// 0x10 C A CS 0x16
+  static const size_t kFixedFrameSize = 4 + AddressSize;
+  /// the length octet counts C, A and at least one asdu octet
+  static const size_t kMinLength = 2 + AddressSize;
+  static const size_t kMinVariableFrameSize = kMinLength + 6;
+
+  /**
+   * @brief prepare for the next frame of the stream
+   */
+  void restart_() {
+    carrySize_ = 0;
+    isE5Frame_ = false;
+    isFixedFrame_ = false;
+    err_ = FrameParseErr::kNeedMoreData;
+    state_ = kStart;
   }
 
   uint8_t ctrlDomain_;
-  uint8_t slaveAddress_;
+  uint16_t slaveAddress_;
   uint8_t length_[2];
   uint8_t cs_;
-  std::vector<uint8_t> asdu_;
   bool isE5Frame_ = false;
+  LinkLayerFrame frame_;
 
   /// internal
   FrameParseErr err_ = FrameParseErr::kNeedMoreData;
   bool isFixedFrame_ = false;
-  std::vector<uint8_t> data_;
   State state_ = kStart;
+  uint8_t sum_ = 0;
+  size_t asduRemaining_ = 0;
+  bool resyncEnabled_ = false;
+  uint64_t discarded_ = 0;
+  bool rawFrameCaptureEnabled_ = false;
+
+  /// fixed buffers, the codec never grows however long it lives
+  /// leading bytes of a frame that did not fit in the previous chunk
+  uint8_t carry_[kMaxFrameLength];
+  size_t carrySize_ = 0;
+  /// bytes of a malformed frame that are scanned again by resync
+  uint8_t replay_[kMaxFrameLength];
+  uint8_t rawFrame_[kMaxFrameLength];
+  size_t rawFrameSize_ = 0;
+};
+
+typedef BasicLinkLayerFrameCodec<1> LinkLayerFrameCodec;
+
+/**
+ * @brief encodes a LinkLayerFrame with a link address of AddressSize
+ * octets, the single octet case is LinkLayerFrame::encode() itself
+ */
+template <size_t AddressSize> struct LinkLayerFrameEncoder {
+  static_assert(AddressSize <= 2, "the link address is 0, 1 or 2 octets");
+
+  /**
+   * @brief the number of bytes encode() writes for frame
+   *
+   * @param frame
+   * @return 0 if the frame can not be encoded, overflowed() or an asdu
+   * longer than 254 - AddressSize
+   */
+  static size_t encodedSize(const LinkLayerFrame &frame) {
+    if (frame.overflowed()) {
+      return 0;
+    }
+    if (frame.isSlaveLevel12UserDataEmpty()) {
+      return 1;
+    }
+    if (!frame.hasAsdu()) {
+      return 4 + AddressSize;
+    }
+    /// L counts C, A and the asdu in one octet
+    if (1 + AddressSize + frame.asduSize() > 255) {
+      return 0;
+    }
+    return 7 + AddressSize + frame.asduSize();
+  }
+
+  /**
+   * @brief
+   *
+   * @param frame
+   * @param buf
+   * @param size
+   * @return the number of bytes written, 0 if size < encodedSize() or the
+   * frame can not be encoded
+   */
+  static size_t encode(const LinkLayerFrame &frame, uint8_t *buf,
+                       size_t size) {
+    const size_t n = encodedSize(frame);
+    if (n == 0 || size < n) {
+      return 0;
+    }
+    if (frame.isSlaveLevel12UserDataEmpty()) {
+      buf[0] = 0xe5;
+      return 1;
+    }
+    uint8_t *header = buf;
+    if (frame.hasAsdu()) {
+      const uint8_t len =
+          static_cast<uint8_t>(1 + AddressSize + frame.asduSize());
+      buf[0] = 0x68;
+      buf[1] = len;
+      buf[2] = len;
+      buf[3] = 0x68;
+      header = buf + 3;
+    } else {
+      buf[0] = 0x10;
+    }
+    header[1] = frame.ctrlDomain();
+    const unsigned address = static_cast<unsigned>(frame.slaveAddress());
+    if (AddressSize >= 1) {
+      header[2] = static_cast<uint8_t>(address);
+    }
+    if (AddressSize == 2) {
+      header[3] = static_cast<uint8_t>(address >> 8);
+    }
+    uint8_t *asdu = header + 2 + AddressSize;
+    std::memcpy(asdu, frame.asduData(), frame.asduSize());
+    asdu[frame.asduSize()] =
+        checksum(header + 1, 1 + AddressSize + frame.asduSize());
+    asdu[frame.asduSize() + 1] = 0x16;
+    return n;
+  }
+};
+
+template <> struct LinkLayerFrameEncoder<1> {
+  static size_t encodedSize(const LinkLayerFrame &frame) {
+    return frame.encodedSize();
+  }
+  static size_t encode(const LinkLayerFrame &frame, uint8_t *buf,
+                       size_t size) {
+    return frame.encode(buf, size);
+  }
 };
 
 } // namespace p101
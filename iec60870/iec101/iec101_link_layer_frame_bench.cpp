@@ -0,0 +1,161 @@
+#include "iec101_control_field.h"
+#include "iec101_link_layer_frame.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+using namespace QIEC60870::p101;
+
+namespace {
+/// frames per decode iteration, enough to amortise the per-call overhead
+const int kFramesPerStream = 64;
+
+enum FrameKind { kFixed, kE5, kVariable };
+
+LinkLayerFrame makeFrame(int kind, size_t asduSize) {
+  LinkLayerFrame frame(0x53, 0x01);
+  if (kind == kE5) {
+    frame.setSlaveLevel12UserDataIsEmpty();
+  } else if (kind == kVariable) {
+    std::vector<uint8_t> asdu(asduSize);
+    for (size_t i = 0; i < asdu.size(); ++i) {
+      asdu[i] = static_cast<uint8_t>(i);
+    }
+    frame = LinkLayerFrame(0x53, 0x01, asdu);
+  }
+  return frame;
+}
+
+std::vector<uint8_t> makeStream(int kind, size_t asduSize) {
+  std::vector<uint8_t> stream;
+  LinkLayerFrame frame = makeFrame(kind, asduSize);
+  for (int i = 0; i < kFramesPerStream; ++i) {
+    frame.encode(std::back_inserter(stream));
+  }
+  return stream;
+}
+
+void setCounters(benchmark::State &state, int64_t frames, int64_t bytes) {
+  state.SetItemsProcessed(state.iterations() * frames);
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+} // namespace
+
+/// args: frame kind, asdu size
+static void BM_Encode(benchmark::State &state) {
+  LinkLayerFrame frame = makeFrame(state.range(0), state.range(1));
+  for (auto _ : state) {
+    auto raw = frame.encode();
+    benchmark::DoNotOptimize(raw.data());
+  }
+  setCounters(state, 1, frame.encodedSize());
+}
+
+/// args: frame kind, asdu size
+static void BM_EncodeIntoBuffer(benchmark::State &state) {
+  LinkLayerFrame frame = makeFrame(state.range(0), state.range(1));
+  uint8_t buf[kMaxFrameLength];
+  for (auto _ : state) {
+    size_t n = frame.encode(buf, sizeof(buf));
+    benchmark::DoNotOptimize(n);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, 1, frame.encodedSize());
+}
+
+/// args: frame kind, asdu size, chunk size (0 for the whole stream at once)
+static void BM_DecodeStream(benchmark::State &state) {
+  auto stream = makeStream(state.range(0), state.range(1));
+  size_t chunk = state.range(2) == 0 ? stream.size() : state.range(2);
+  LinkLayerFrameCodec codec;
+  size_t frames = 0;
+  auto count = [&frames](const LinkLayerFrameView &view) {
+    benchmark::DoNotOptimize(view.asdu());
+    ++frames;
+  };
+  for (auto _ : state) {
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+      codec.decodeStream(stream.data() + i,
+                         std::min(chunk, stream.size() - i), count);
+    }
+  }
+  if (frames != static_cast<size_t>(state.iterations()) * kFramesPerStream) {
+    state.SkipWithError("frames lost");
+  }
+  setCounters(state, kFramesPerStream, stream.size());
+}
+
+/// args: frame kind, asdu size
+static void BM_DecodeOneFrame(benchmark::State &state) {
+  auto raw = makeFrame(state.range(0), state.range(1)).encode();
+  for (auto _ : state) {
+    LinkLayerFrameCodec codec;
+    codec.decode(raw);
+    LinkLayerFrame frame = codec.toLinkLayerFrame();
+    benchmark::DoNotOptimize(frame);
+  }
+  setCounters(state, 1, raw.size());
+}
+
+/// poll class 2 from the precomputed table, compare with BM_EncodeIntoBuffer
+static void BM_PollFromTable(benchmark::State &state) {
+  uint8_t buf[FixedFrame::kSize];
+  uint8_t address = 0;
+  FCB fcb = FCB::k0;
+  for (auto _ : state) {
+    frames::requestClass2(++address, fcb).copyTo(buf);
+    fcb = fcb == FCB::k0 ? FCB::k1 : FCB::k0;
+    benchmark::DoNotOptimize(buf);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, 1, FixedFrame::kSize);
+}
+
+/// the same poll frame built with the setters
+static void BM_PollWithSetters(benchmark::State &state) {
+  uint8_t buf[FixedFrame::kSize];
+  uint8_t address = 0;
+  FCB fcb = FCB::k0;
+  for (auto _ : state) {
+    LinkLayerFrame frame(0, ++address);
+    frame.setPRM(PRM::kFromStartupStation);
+    frame.setFCB(fcb);
+    frame.setFCV(FCV::kFCBValid);
+    frame.setFC(static_cast<int>(StartupFunction::kRequestLevel2UserData));
+    frame.encode(buf, sizeof(buf));
+    fcb = fcb == FCB::k0 ? FCB::k1 : FCB::k0;
+    benchmark::DoNotOptimize(buf);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, 1, FixedFrame::kSize);
+}
+
+static void FrameKinds(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"kind", "asdu"});
+  b->Args({kFixed, 0});
+  b->Args({kE5, 0});
+  for (int asduSize : {8, 32, 128, static_cast<int>(kMaxAsduLength)}) {
+    b->Args({kVariable, asduSize});
+  }
+}
+
+static void FrameKindsAndChunks(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"kind", "asdu", "chunk"});
+  for (int chunk : {0, 1, 16, 256}) {
+    b->Args({kFixed, 0, chunk});
+    b->Args({kE5, 0, chunk});
+    for (int asduSize : {8, 32, 128, static_cast<int>(kMaxAsduLength)}) {
+      b->Args({kVariable, asduSize, chunk});
+    }
+  }
+}
+
+BENCHMARK(BM_Encode)->Apply(FrameKinds);
+BENCHMARK(BM_EncodeIntoBuffer)->Apply(FrameKinds);
+BENCHMARK(BM_DecodeStream)->Apply(FrameKindsAndChunks);
+BENCHMARK(BM_DecodeOneFrame)->Apply(FrameKinds);
+BENCHMARK(BM_PollFromTable);
+BENCHMARK(BM_PollWithSetters);
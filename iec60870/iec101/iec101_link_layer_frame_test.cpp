@@ -3,6 +3,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <iterator>
+
 using namespace testing;
 using namespace QIEC60870::p101;
 
@@ -218,3 +221,452 @@ TEST(LinkLayer, frame_ctrlDomain_set) {
   uint8_t c = frame.ctrlDomain();
   EXPECT_EQ(c, 0x78);
 }
+
+TEST(LinkLayer, frameCodec_decodeStream_multi_frames) {
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrame> frames;
+
+  std::vector<uint8_t> data = {0x10, 0x5a, 0x01, 0x5b, 0x16, 0xe5,
+                               0x68, 0x09, 0x09, 0x68, 0x08, 0x01,
+                               0x46, 0x01, 0x04, 0x01, 0x00, 0x00,
+                               0x00, 0x55, 0x16, 0x10, 0x49};
+  EXPECT_EQ(codec.decodeStream(data, frames), 3u);
+  EXPECT_EQ(codec.error(), FrameParseErr::kNeedMoreData);
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].ctrlDomain(), 0x5a);
+  EXPECT_EQ(frames[1].isSlaveLevel12UserDataEmpty(), true);
+  EXPECT_THAT(frames[2].asdu(),
+              ElementsAre(0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00));
+
+  /// the partial fixed frame is completed by the next chunk
+  EXPECT_EQ(codec.decodeStream(std::vector<uint8_t>({0x01, 0x4a, 0x16}),
+                               frames),
+            1u);
+  ASSERT_EQ(frames.size(), 4u);
+  EXPECT_EQ(frames[3].ctrlDomain(), 0x49);
+  EXPECT_EQ(frames[3].slaveAddress(), 0x01);
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_byte_by_byte) {
+  LinkLayerFrame frame(
+      0x08, 0x01,
+      std::vector<uint8_t>({0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00}));
+  auto raw = frame.encode();
+
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrame> frames;
+  for (int n = 0; n < 3; ++n) {
+    for (const auto &ch : raw) {
+      codec.decodeStream(&ch, 1, frames);
+    }
+  }
+  ASSERT_EQ(frames.size(), 3u);
+  for (auto &f : frames) {
+    EXPECT_EQ(f.asdu(), frame.asdu());
+  }
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_stops_at_bad_frame) {
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrame> frames;
+
+  std::vector<uint8_t> data = {0x10, 0x5a, 0x01, 0x5b, 0x16,
+                               0x10, 0x5a, 0x01, 0x5c, 0x16, 0xe5};
+  EXPECT_EQ(codec.decodeStream(data, frames), 1u);
+  EXPECT_EQ(codec.error(), FrameParseErr::kCheckError);
+  EXPECT_EQ(codec.decodeStream(std::vector<uint8_t>({0xe5}), frames), 0u);
+  EXPECT_EQ(frames.size(), 1u);
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_resync) {
+  LinkLayerFrameCodec codec;
+  codec.setResyncEnabled(true);
+  std::vector<LinkLayerFrame> frames;
+
+  std::vector<uint8_t> data = {
+      0x00, 0xff,                         /// line garbage
+      0x10, 0x5a, 0x01, 0x5c, 0x16,       /// bad cs
+      0x10, 0x5a, 0x01, 0x5b, 0x16,       /// ok
+      0x68, 0x09, 0x07, 0x68,             /// length mismatch
+      0x68, 0x09, 0x09, 0x68, 0x08, 0x01, 0x46, 0x01, 0x04, 0x01, 0x00, 0x00,
+      0x00, 0x55, 0x16,                   /// ok
+      0x68, 0x01, 0x01, 0x16,             /// too short
+      0xe5};
+  EXPECT_EQ(codec.decodeStream(data, frames), 3u);
+  ASSERT_EQ(frames.size(), 3u);
+  EXPECT_EQ(frames[0].ctrlDomain(), 0x5a);
+  EXPECT_EQ(frames[1].hasAsdu(), true);
+  EXPECT_EQ(frames[2].isSlaveLevel12UserDataEmpty(), true);
+  EXPECT_EQ(codec.discardedBytes(), 2u + 5u + 4u + 4u);
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_resync_finds_frame_inside_bad_one) {
+  LinkLayerFrameCodec codec;
+  codec.setResyncEnabled(true);
+  std::vector<LinkLayerFrame> frames;
+
+  /// a bogus 0x68 header swallows a fixed frame, which only shows up once
+  /// the bogus frame fails its end byte
+  std::vector<uint8_t> data = {0x68, 0x04, 0x04, 0x68, 0x10, 0x5a,
+                               0x01, 0x5b, 0x16, 0x10, 0x49};
+  EXPECT_EQ(codec.decodeStream(data, frames), 1u);
+  EXPECT_EQ(codec.decodeStream(std::vector<uint8_t>({0x01, 0x4a, 0x16}),
+                               frames),
+            1u);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].ctrlDomain(), 0x5a);
+  EXPECT_EQ(frames[1].ctrlDomain(), 0x49);
+  EXPECT_EQ(codec.discardedBytes(), 4u);
+  EXPECT_EQ(codec.error(), FrameParseErr::kNoError);
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_views_point_into_buffer) {
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrameView> views;
+
+  std::vector<uint8_t> data = {0x10, 0x5a, 0x01, 0x5b, 0x16, 0x68, 0x09,
+                               0x09, 0x68, 0x08, 0x01, 0x46, 0x01, 0x04,
+                               0x01, 0x00, 0x00, 0x00, 0x55, 0x16, 0xe5};
+  auto keep = [&views](const LinkLayerFrameView &view) {
+    views.push_back(view);
+  };
+  EXPECT_EQ(codec.decodeStream(data, keep), 3u);
+  ASSERT_EQ(views.size(), 3u);
+
+  EXPECT_EQ(views[0].hasAsdu(), false);
+  EXPECT_EQ(views[0].ctrlDomain(), 0x5a);
+  EXPECT_EQ(views[0].slaveAddress(), 0x01);
+  EXPECT_EQ(views[0].raw(), data.data());
+  EXPECT_EQ(views[0].rawSize(), 5u);
+
+  EXPECT_EQ(views[1].ctrlDomain(), 0x08);
+  EXPECT_EQ(views[1].asdu(), data.data() + 11);
+  EXPECT_EQ(views[1].asduSize(), 7u);
+
+  EXPECT_EQ(views[2].isSlaveLevel12UserDataEmpty(), true);
+  EXPECT_EQ(views[2].raw(), data.data() + 20);
+}
+
+TEST(LinkLayer, frameCodec_decodeStream_views_across_chunks) {
+  LinkLayerFrameCodec codec;
+  std::vector<std::vector<uint8_t>> asdus;
+  auto keep = [&asdus](const LinkLayerFrameView &view) {
+    asdus.push_back(
+        std::vector<uint8_t>(view.asdu(), view.asdu() + view.asduSize()));
+  };
+
+  std::vector<uint8_t> data = {0x68, 0x09, 0x09, 0x68, 0x08, 0x01, 0x46, 0x01,
+                               0x04, 0x01, 0x00, 0x00, 0x00, 0x55, 0x16};
+  for (size_t cut = 1; cut < data.size(); ++cut) {
+    EXPECT_EQ(codec.decodeStream(data.data(), cut, keep), 0u);
+    EXPECT_EQ(codec.decodeStream(data.data() + cut, data.size() - cut, keep),
+              1u);
+  }
+  ASSERT_EQ(asdus.size(), data.size() - 1);
+  for (const auto &asdu : asdus) {
+    EXPECT_THAT(asdu, ElementsAre(0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00));
+  }
+}
+
+TEST(LinkLayer, frame_encode_into_buffer) {
+  LinkLayerFrame fixedFrame(0x5a, 0x01);
+  LinkLayerFrame variableFrame(
+      0x08, 0x01,
+      std::vector<uint8_t>({0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00}));
+  LinkLayerFrame e5Frame;
+  e5Frame.setSlaveLevel12UserDataIsEmpty();
+
+  EXPECT_EQ(fixedFrame.encodedSize(), 5u);
+  EXPECT_EQ(variableFrame.encodedSize(), 15u);
+  EXPECT_EQ(e5Frame.encodedSize(), 1u);
+
+  uint8_t buf[32];
+  size_t n = 0;
+  n += fixedFrame.encode(buf + n, sizeof(buf) - n);
+  n += variableFrame.encode(buf + n, sizeof(buf) - n);
+  n += e5Frame.encode(buf + n, sizeof(buf) - n);
+  ASSERT_EQ(n, 21u);
+  EXPECT_THAT(std::vector<uint8_t>(buf, buf + n),
+              ElementsAre(0x10, 0x5a, 0x01, 0x5b, 0x16, 0x68, 0x09, 0x09, 0x68,
+                          0x08, 0x01, 0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00,
+                          0x55, 0x16, 0xe5));
+
+  /// too small, nothing written
+  EXPECT_EQ(variableFrame.encode(buf, 14), 0u);
+}
+
+TEST(LinkLayer, frame_encode_output_iterator) {
+  LinkLayerFrame variableFrame(
+      0x08, 0x01,
+      std::vector<uint8_t>({0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00}));
+  std::vector<uint8_t> raw;
+  EXPECT_EQ(variableFrame.encode(std::back_inserter(raw)), 15u);
+  EXPECT_EQ(raw, variableFrame.encode());
+}
+
+TEST(LinkLayer, frame_asdu_stored_inline) {
+  std::vector<uint8_t> asdu = {0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00};
+  LinkLayerFrame frame(0x08, 0x01, asdu.data(), asdu.size());
+  LinkLayerFrame copy = frame;
+
+  EXPECT_EQ(copy.asduSize(), asdu.size());
+  EXPECT_NE(copy.asduData(), frame.asduData());
+  EXPECT_EQ(copy.asdu(), asdu);
+  EXPECT_EQ(copy.encode(), frame.encode());
+
+}
+
+TEST(LinkLayer, frame_refuses_too_long_asdu) {
+  std::vector<uint8_t> asdu(kMaxAsduLength, 0x01);
+  LinkLayerFrame frame(0x08, 0x01);
+  EXPECT_TRUE(frame.setAsdu(asdu.data(), asdu.size()));
+  EXPECT_FALSE(frame.overflowed());
+  EXPECT_EQ(frame.encodedSize(), 261u);
+
+  /// held for the link without an address, too long for this one
+  asdu.push_back(0x01);
+  EXPECT_TRUE(frame.setAsdu(asdu.data(), asdu.size()));
+  EXPECT_FALSE(frame.overflowed());
+  EXPECT_EQ(frame.asduSize(), kMaxAsduCapacity);
+  EXPECT_EQ(frame.encodedSize(), 0u);
+  EXPECT_EQ(LinkLayerFrameEncoder<0>::encodedSize(frame), 261u);
+
+  asdu.push_back(0x01);
+  EXPECT_FALSE(frame.setAsdu(asdu.data(), asdu.size()));
+  EXPECT_TRUE(frame.overflowed());
+  EXPECT_EQ(frame.encodedSize(), 0u);
+  uint8_t buf[kMaxFrameLength + 8];
+  EXPECT_EQ(frame.encode(buf, sizeof(buf)), 0u);
+  EXPECT_TRUE(frame.encode().empty());
+  std::vector<uint8_t> viaIterator;
+  EXPECT_EQ(frame.encode(std::back_inserter(viaIterator)), 0u);
+  EXPECT_TRUE(viaIterator.empty());
+  EXPECT_EQ(LinkLayerFrameEncoder<0>::encode(frame, buf, sizeof(buf)), 0u);
+  EXPECT_EQ(LinkLayerFrameEncoder<2>::encode(frame, buf, sizeof(buf)), 0u);
+
+  LinkLayerFrame constructed(0x08, 0x01, asdu);
+  EXPECT_TRUE(constructed.overflowed());
+  EXPECT_EQ(constructed.encodedSize(), 0u);
+}
+
+TEST(LinkLayer, frame_encode_decode_long_asdu) {
+  std::vector<uint8_t> asdu(kMaxAsduLength);
+  for (size_t i = 0; i < asdu.size(); ++i) {
+    asdu[i] = static_cast<uint8_t>(i * 7 + 3);
+  }
+  LinkLayerFrame frame(0x73, 0x12, asdu);
+  auto raw = frame.encode();
+  std::vector<uint8_t> viaIterator;
+  frame.encode(std::back_inserter(viaIterator));
+  EXPECT_EQ(raw, viaIterator);
+
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrame> frames;
+  EXPECT_EQ(codec.decodeStream(raw, frames), 1u);
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(frames[0].asdu(), asdu);
+}
+
+TEST(LinkLayer, frameCodec_whole_and_fragmented_frames_agree) {
+  std::vector<uint8_t> stream;
+  for (uint8_t n = 1; n < 40; ++n) {
+    std::vector<uint8_t> asdu(n * 3 % 200 + 1, n);
+    LinkLayerFrame(0x08 | (n & 0x07), n, asdu)
+        .encode(std::back_inserter(stream));
+    LinkLayerFrame(0x49, n).encode(std::back_inserter(stream));
+    stream.push_back(0xe5);
+  }
+
+  std::vector<LinkLayerFrame> whole;
+  LinkLayerFrameCodec wholeCodec;
+  EXPECT_EQ(wholeCodec.decodeStream(stream, whole), 39u * 3);
+
+  for (size_t chunk : {1u, 2u, 3u, 7u, 64u}) {
+    std::vector<LinkLayerFrame> fragmented;
+    LinkLayerFrameCodec codec;
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+      size_t n = std::min(chunk, stream.size() - i);
+      codec.decodeStream(stream.data() + i, n, fragmented);
+    }
+    ASSERT_EQ(fragmented.size(), whole.size()) << chunk;
+    for (size_t i = 0; i < whole.size(); ++i) {
+      EXPECT_EQ(fragmented[i].encode(), whole[i].encode()) << chunk;
+    }
+  }
+}
+
+TEST(LinkLayer, frameCodec_reset) {
+  LinkLayerFrameCodec codec;
+  std::vector<LinkLayerFrame> frames;
+
+  codec.decodeStream(std::vector<uint8_t>({0x10, 0x5a, 0x01, 0x5c, 0x16}),
+                     frames);
+  EXPECT_EQ(codec.error(), FrameParseErr::kCheckError);
+  codec.reset();
+  EXPECT_EQ(codec.error(), FrameParseErr::kNeedMoreData);
+
+  /// a partial frame is dropped too
+  codec.decodeStream(std::vector<uint8_t>({0x68, 0x09, 0x09}), frames);
+  codec.reset();
+  EXPECT_EQ(codec.decodeStream(
+                std::vector<uint8_t>({0x10, 0x5a, 0x01, 0x5b, 0x16}), frames),
+            1u);
+  EXPECT_EQ(frames.size(), 1u);
+}
+
+TEST(LinkLayer, frameCodec_raw_frame_capture) {
+  LinkLayerFrameCodec codec;
+  codec.setResyncEnabled(true);
+  std::vector<LinkLayerFrame> frames;
+
+  std::vector<uint8_t> data = {0x68, 0x09, 0x09, 0x68, 0x08, 0x01, 0x46, 0x01,
+                               0x04, 0x01, 0x00, 0x00, 0x00, 0x55, 0x16};
+  codec.decodeStream(data, frames);
+  EXPECT_TRUE(codec.lastRawFrame().empty());
+
+  codec.setRawFrameCaptureEnabled(true);
+  codec.decodeStream(data.data(), 4, frames);
+  codec.decodeStream(data.data() + 4, data.size() - 4, frames);
+  EXPECT_EQ(codec.lastRawFrame(), data);
+
+  codec.decodeStream(std::vector<uint8_t>({0x10, 0x5a, 0x01, 0x5c, 0x16}),
+                     frames);
+  EXPECT_THAT(codec.lastRawFrame(), ElementsAre(0x10, 0x5a, 0x01, 0x5c, 0x16));
+  EXPECT_EQ(frames.size(), 2u);
+}
+
+TEST(LinkLayer, frameEncoder_two_octet_address) {
+  LinkLayerFrame fixedFrame(0x5a, 0x1234);
+  uint8_t buf[kMaxFrameLength + 1];
+  ASSERT_EQ(LinkLayerFrameEncoder<2>::encode(fixedFrame, buf, sizeof(buf)),
+            6u);
+  EXPECT_THAT(std::vector<uint8_t>(buf, buf + 6),
+              ElementsAre(0x10, 0x5a, 0x34, 0x12, 0xa0, 0x16));
+
+  LinkLayerFrame variableFrame(0x08, 0x1234,
+                               std::vector<uint8_t>({0x46, 0x01, 0x04}));
+  ASSERT_EQ(LinkLayerFrameEncoder<2>::encodedSize(variableFrame), 12u);
+  EXPECT_EQ(LinkLayerFrameEncoder<2>::encode(variableFrame, buf, 11), 0u);
+  ASSERT_EQ(LinkLayerFrameEncoder<2>::encode(variableFrame, buf, sizeof(buf)),
+            12u);
+  EXPECT_THAT(std::vector<uint8_t>(buf, buf + 12),
+              ElementsAre(0x68, 0x06, 0x06, 0x68, 0x08, 0x34, 0x12, 0x46,
+                          0x01, 0x04, 0x99, 0x16));
+}
+
+TEST(LinkLayer, frameEncoder_two_octet_address_length_limit) {
+  /// L = 1 + 2 + 252 = 255
+  std::vector<uint8_t> asdu(252, 0x5a);
+  LinkLayerFrame frame(0x08, 0x0102, asdu);
+  std::vector<uint8_t> data(kMaxFrameLength);
+  ASSERT_EQ(LinkLayerFrameEncoder<2>::encodedSize(frame), 261u);
+  ASSERT_EQ(LinkLayerFrameEncoder<2>::encode(frame, data.data(), data.size()),
+            261u);
+  EXPECT_EQ(data[1], 0xff);
+  EXPECT_EQ(data[2], 0xff);
+
+  BasicLinkLayerFrameCodec<2> codec;
+  std::vector<LinkLayerFrame> frames;
+  codec.decodeStream(data.data(), data.size(), frames);
+  ASSERT_EQ(frames.size(), 1u);
+  EXPECT_EQ(frames[0].slaveAddress(), 0x0102);
+  EXPECT_EQ(frames[0].asdu(), asdu);
+
+  /// one more would wrap L to 0
+  asdu.push_back(0x5a);
+  ASSERT_TRUE(frame.setAsdu(asdu.data(), asdu.size()));
+  EXPECT_EQ(LinkLayerFrameEncoder<2>::encodedSize(frame), 0u);
+  EXPECT_EQ(LinkLayerFrameEncoder<2>::encode(frame, data.data(), data.size()),
+            0u);
+}
+
+TEST(LinkLayer, frameEncoder_one_octet_address_is_frame_encode) {
+  LinkLayerFrame frame(0x08, 0x01, std::vector<uint8_t>({0x46, 0x01, 0x04}));
+  uint8_t buf[kMaxFrameLength];
+  size_t n = LinkLayerFrameEncoder<1>::encode(frame, buf, sizeof(buf));
+  EXPECT_EQ(std::vector<uint8_t>(buf, buf + n), frame.encode());
+}
+
+TEST(LinkLayer, frameCodec_two_octet_address_roundtrip) {
+  LinkLayerFrame fixedFrame(0x49, 0xfffe);
+  LinkLayerFrame variableFrame(
+      0x08, 0x0102,
+      std::vector<uint8_t>({0x46, 0x01, 0x04, 0x01, 0x00, 0x00, 0x00}));
+  std::vector<uint8_t> data(kMaxFrameLength * 2);
+  size_t size =
+      LinkLayerFrameEncoder<2>::encode(fixedFrame, data.data(), data.size());
+  size += LinkLayerFrameEncoder<2>::encode(variableFrame, data.data() + size,
+                                           data.size() - size);
+  data.resize(size);
+
+  /// whole frames, then byte by byte through the state machine
+  for (size_t chunk : {size, size_t(1)}) {
+    BasicLinkLayerFrameCodec<2> codec;
+    std::vector<LinkLayerFrame> frames;
+    for (size_t i = 0; i < size; i += chunk) {
+      codec.decodeStream(data.data() + i, std::min(chunk, size - i), frames);
+    }
+    ASSERT_EQ(frames.size(), 2u) << chunk;
+    EXPECT_EQ(frames[0].slaveAddress(), 0xfffe);
+    EXPECT_FALSE(frames[0].hasAsdu());
+    EXPECT_EQ(frames[1].slaveAddress(), 0x0102);
+    EXPECT_EQ(frames[1].asdu(), variableFrame.asdu());
+  }
+}
+
+TEST(LinkLayer, frameCodec_no_address_roundtrip) {
+  LinkLayerFrame fixedFrame(0x49, 0x00);
+  LinkLayerFrame variableFrame(0x08, 0x00,
+                               std::vector<uint8_t>({0x46, 0x01, 0x04}));
+  uint8_t buf[kMaxFrameLength];
+  ASSERT_EQ(LinkLayerFrameEncoder<0>::encode(fixedFrame, buf, sizeof(buf)),
+            4u);
+  EXPECT_THAT(std::vector<uint8_t>(buf, buf + 4),
+              ElementsAre(0x10, 0x49, 0x49, 0x16));
+
+  size_t n = LinkLayerFrameEncoder<0>::encode(variableFrame, buf, sizeof(buf));
+  ASSERT_EQ(n, 10u);
+  BasicLinkLayerFrameCodec<0> codec;
+  std::vector<LinkLayerFrame> frames;
+  codec.decodeStream(buf, n, frames);
+  codec.decodeStream(buf, 2, frames);
+  codec.decodeStream(buf + 2, n - 2, frames);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].asdu(), variableFrame.asdu());
+  EXPECT_EQ(frames[1].asdu(), variableFrame.asdu());
+}
+
+TEST(LinkLayer, frameCodec_no_address_longest_asdu) {
+  /// L = 1 + 254 = 255, one octet more than the single octet link holds
+  std::vector<uint8_t> asdu(kMaxAsduCapacity);
+  for (size_t i = 0; i < asdu.size(); ++i) {
+    asdu[i] = static_cast<uint8_t>(i);
+  }
+  LinkLayerFrame frame(0x08, 0x00, asdu);
+  std::vector<uint8_t> data(kMaxFrameLength);
+  ASSERT_EQ(LinkLayerFrameEncoder<0>::encode(frame, data.data(), data.size()),
+            kMaxFrameLength);
+  EXPECT_EQ(data[1], 0xff);
+
+  BasicLinkLayerFrameCodec<0> codec;
+  codec.decode(data);
+  ASSERT_EQ(codec.error(), FrameParseErr::kNoError);
+  EXPECT_EQ(codec.toLinkLayerFrame().asdu(), asdu);
+
+  std::vector<LinkLayerFrame> frames;
+  codec.reset();
+  codec.decodeStream(data.data(), data.size(), frames);
+  codec.decodeStream(data.data(), 100, frames);
+  codec.decodeStream(data.data() + 100, data.size() - 100, frames);
+  ASSERT_EQ(frames.size(), 2u);
+  EXPECT_EQ(frames[0].asdu(), asdu);
+  EXPECT_EQ(frames[1].asdu(), asdu);
+}
+
+TEST(LinkLayer, frameCodec_two_octet_address_checks_length) {
+  /// L covers C and both address octets, so 3 is one short
+  BasicLinkLayerFrameCodec<2> codec;
+  codec.decode(std::vector<uint8_t>(
+      {0x68, 0x03, 0x03, 0x68, 0x08, 0x01, 0x00, 0x09, 0x16}));
+  EXPECT_EQ(codec.error(), FrameParseErr::kBadFormat);
+}
@@ -0,0 +1,358 @@
+#ifndef IEC104_APCI_H
+#define IEC104_APCI_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iec_asdu_limits.h"
+
+namespace QIEC60870 {
+namespace p104 {
+enum class ApduParseErr { kNoError = 0, kNeedMoreData = 1, kBadFormat = 2 };
+
+enum class FrameType { kIFrame, kSFrame, kUFrame };
+
+/**
+ * @brief the first control octet of a U frame, exactly one function bit set
+ */
+enum class UFunction {
+  kStartDtAct = 0x07,
+  kStartDtCon = 0x0b,
+  kStopDtAct = 0x13,
+  kStopDtCon = 0x23,
+  kTestFrAct = 0x43,
+  kTestFrCon = 0x83,
+};
+
+/// 0x68 L and the four control octets
+const size_t kApciSize = 6;
+/// the length octet counts the control octets and the asdu
+const size_t kMaxApduLength = 253;
+const size_t kMaxApduSize = kMaxApduLength + 2;
+const size_t kMaxAsduLength = kMaxIec104AsduLength;
+static_assert(kMaxAsduLength == kMaxApduLength - 4,
+              "the asdu follows the four control octets");
+/// N(S) and N(R) count modulo 2^15
+const uint16_t kSequenceModulo = 32768;
+
+/**
+ * @brief A decoded apdu that still lives in the receive buffer,
+ * asdu() points into the raw bytes instead of owning a copy
+ */
+class ApduView {
+public:
+  ApduView() = default;
+
+  ApduView(const uint8_t *raw, size_t rawSize) : raw_(raw), rawSize_(rawSize) {}
+
+  FrameType type() const {
+    if ((raw_[2] & 0x01) == 0) {
+      return FrameType::kIFrame;
+    }
+    return (raw_[2] & 0x02) == 0 ? FrameType::kSFrame : FrameType::kUFrame;
+  }
+  bool isIFrame() const { return type() == FrameType::kIFrame; }
+  bool isSFrame() const { return type() == FrameType::kSFrame; }
+  bool isUFrame() const { return type() == FrameType::kUFrame; }
+
+  /**
+   * @brief N(S), I frames only
+   *
+   * @return
+   */
+  uint16_t sendSequence() const {
+    return static_cast<uint16_t>((raw_[2] | (raw_[3] << 8)) >> 1);
+  }
+  /**
+   * @brief N(R), I and S frames
+   *
+   * @return
+   */
+  uint16_t receiveSequence() const {
+    return static_cast<uint16_t>((raw_[4] | (raw_[5] << 8)) >> 1);
+  }
+  /**
+   * @brief U frames only
+   *
+   * @return
+   */
+  UFunction uFunction() const { return static_cast<UFunction>(raw_[2]); }
+
+  /**
+   * @brief the asdu of an I frame, empty for S and U frames
+   *
+   * @return
+   */
+  const uint8_t *asdu() const { return raw_ + kApciSize; }
+  size_t asduSize() const { return rawSize_ - kApciSize; }
+
+  /**
+   * @brief the whole apdu, from the start byte on
+   *
+   * @return
+   */
+  const uint8_t *raw() const { return raw_; }
+  size_t rawSize() const { return rawSize_; }
+
+private:
+  const uint8_t *raw_ = nullptr;
+  size_t rawSize_ = 0;
+};
+
+/**
+ * @brief Decodes apdus from a tcp byte stream in a single pass. an apdu
+ * that lies whole in the chunk is checked from its six apci octets and
+ * viewed in place, the asdu is never touched; only the bytes of an apdu cut
+ * by the end of a chunk are copied, into a fixed buffer inside the codec,
+ * and it is completed by the next chunk. one codec per connection for its
+ * whole lifetime.
+ * there is no resync: a malformed apdu means the peer is out of step, so
+ * decoding stops, error() reports kBadFormat and the connection should be
+ * closed
+ */
+class ApduCodec {
+public:
+  /**
+   * @brief decode a chunk of the stream, handler is called with an ApduView
+   * for every complete apdu. a view of an apdu that lies whole in data is
+   * valid as long as data is, a view of an apdu completed from kept bytes
+   * only until handler returns
+   *
+   * @param data
+   * @param size
+   * @param handler callable as handler(const ApduView &)
+   * @return the number of apdus passed to handler
+   */
+  template <typename Handler>
+  size_t decodeStream(const uint8_t *data, size_t size, Handler &&handler) {
+    /// an empty chunk, e.g. an empty vector, may come with data nullptr
+    if (err_ == ApduParseErr::kBadFormat || size == 0) {
+      return 0;
+    }
+    size_t count = 0;
+    size_t i = 0;
+    if (carrySize_ != 0) {
+      i = complete_(data, size);
+      if (err_ == ApduParseErr::kBadFormat) {
+        return 0;
+      }
+      if (carrySize_ < 2 || carrySize_ < carry_[1] + 2u) {
+        return 0;
+      }
+      handler(ApduView(carry_, carrySize_));
+      ++count;
+      carrySize_ = 0;
+    }
+    while (size - i >= 2) {
+      if (!checkHeader_(data[i], data[i + 1])) {
+        return count;
+      }
+      const size_t apduSize = data[i + 1] + 2u;
+      if (size - i < apduSize) {
+        break;
+      }
+      if (!checkControl_(data + i)) {
+        return count;
+      }
+      handler(ApduView(data + i, apduSize));
+      ++count;
+      i += apduSize;
+    }
+    if (size != i) {
+      std::memcpy(carry_, data + i, size - i);
+    }
+    carrySize_ = size - i;
+    err_ = carrySize_ == 0 ? ApduParseErr::kNoError
+                           : ApduParseErr::kNeedMoreData;
+    return count;
+  }
+
+  template <typename Handler>
+  size_t decodeStream(const std::vector<uint8_t> &data, Handler &&handler) {
+    return decodeStream(data.data(), data.size(), handler);
+  }
+
+  /**
+   * @brief kNeedMoreData while an apdu is cut by the end of the last chunk
+   *
+   * @return
+   */
+  ApduParseErr error() const { return err_; }
+
+  /**
+   * @brief forget any partial apdu and error, e.g. after a reconnect
+   */
+  void reset() {
+    carrySize_ = 0;
+    err_ = ApduParseErr::kNoError;
+  }
+
+private:
+  /**
+   * @brief move the missing bytes of the kept apdu from data into carry_
+   *
+   * @return the number of bytes taken from data
+   */
+  size_t complete_(const uint8_t *data, size_t size) {
+    size_t taken = 0;
+    if (carrySize_ == 1 && size != 0) {
+      carry_[carrySize_++] = data[taken++];
+    }
+    if (carrySize_ < 2) {
+      return taken;
+    }
+    if (!checkHeader_(carry_[0], carry_[1])) {
+      return taken;
+    }
+    const size_t missing = carry_[1] + 2u - carrySize_;
+    const size_t n = size - taken < missing ? size - taken : missing;
+    std::memcpy(carry_ + carrySize_, data + taken, n);
+    carrySize_ += n;
+    taken += n;
+    if (n == missing) {
+      checkControl_(carry_);
+    }
+    return taken;
+  }
+
+  bool checkHeader_(uint8_t start, uint8_t length) {
+    if (start != 0x68 || length < 4 || length > kMaxApduLength) {
+      err_ = ApduParseErr::kBadFormat;
+      return false;
+    }
+    return true;
+  }
+
+  /**
+   * @brief an I frame has an asdu, S and U frames have none, the second
+   * control octet of S and U frames and the low bit of N(R) are 0, and a
+   * U frame has exactly one function bit
+   *
+   * @param apdu a complete apdu with a checked header
+   * @return
+   */
+  bool checkControl_(const uint8_t *apdu) {
+    const uint8_t length = apdu[1];
+    const uint8_t c1 = apdu[2];
+    bool ok = (apdu[4] & 0x01) == 0;
+    if ((c1 & 0x01) == 0) {
+      ok = ok && length > 4;
+    } else if ((c1 & 0x02) == 0) {
+      ok = ok && length == 4 && c1 == 0x01 && apdu[3] == 0;
+    } else {
+      const uint8_t function = c1 & 0xfc;
+      ok = length == 4 && apdu[3] == 0 && apdu[4] == 0 && apdu[5] == 0 &&
+           function != 0 && (function & (function - 1)) == 0;
+    }
+    if (!ok) {
+      err_ = ApduParseErr::kBadFormat;
+    }
+    return ok;
+  }
+
+  ApduParseErr err_ = ApduParseErr::kNoError;
+  /// leading bytes of an apdu that did not fit in the previous chunk
+  uint8_t carry_[kMaxApduSize];
+  size_t carrySize_ = 0;
+};
+
+namespace detail {
+inline void writeSequence(uint16_t sequence, uint8_t *p) {
+  const unsigned v = static_cast<unsigned>(sequence % kSequenceModulo) << 1;
+  p[0] = static_cast<uint8_t>(v);
+  p[1] = static_cast<uint8_t>(v >> 8);
+}
+} // namespace detail
+
+/**
+ * @brief write the apci of an I frame whose asdu is already at
+ * buf + kApciSize, so an asdu can be serialised straight into the send
+ * buffer
+ *
+ * @param sendSequence N(S), taken modulo kSequenceModulo
+ * @param receiveSequence N(R), taken modulo kSequenceModulo
+ * @param asduSize 1 .. kMaxAsduLength
+ * @param buf
+ * @return the apdu size, kApciSize + asduSize
+ */
+inline size_t encodeIFrameHeader(uint16_t sendSequence,
+                                 uint16_t receiveSequence, size_t asduSize,
+                                 uint8_t *buf) {
+  buf[0] = 0x68;
+  buf[1] = static_cast<uint8_t>(asduSize + 4);
+  detail::writeSequence(sendSequence, buf + 2);
+  detail::writeSequence(receiveSequence, buf + 4);
+  return kApciSize + asduSize;
+}
+
+/**
+ * @brief
+ *
+ * @param sendSequence
+ * @param receiveSequence
+ * @param asdu
+ * @param asduSize 1 .. kMaxAsduLength
+ * @param buf
+ * @param size
+ * @return the number of bytes written, 0 if size is too small or asduSize
+ * is out of range
+ */
+inline size_t encodeIFrame(uint16_t sendSequence, uint16_t receiveSequence,
+                           const uint8_t *asdu, size_t asduSize, uint8_t *buf,
+                           size_t size) {
+  if (asduSize == 0 || asduSize > kMaxAsduLength ||
+      size < kApciSize + asduSize) {
+    return 0;
+  }
+  std::memcpy(buf + kApciSize, asdu, asduSize);
+  return encodeIFrameHeader(sendSequence, receiveSequence, asduSize, buf);
+}
+
+/**
+ * @brief
+ *
+ * @param receiveSequence N(R), taken modulo kSequenceModulo
+ * @param buf
+ * @param size
+ * @return kApciSize, 0 if size is too small
+ */
+inline size_t encodeSFrame(uint16_t receiveSequence, uint8_t *buf,
+                           size_t size) {
+  if (size < kApciSize) {
+    return 0;
+  }
+  buf[0] = 0x68;
+  buf[1] = 0x04;
+  buf[2] = 0x01;
+  buf[3] = 0x00;
+  detail::writeSequence(receiveSequence, buf + 4);
+  return kApciSize;
+}
+
+/**
+ * @brief
+ *
+ * @param function
+ * @param buf
+ * @param size
+ * @return kApciSize, 0 if size is too small
+ */
+inline size_t encodeUFrame(UFunction function, uint8_t *buf, size_t size) {
+  if (size < kApciSize) {
+    return 0;
+  }
+  buf[0] = 0x68;
+  buf[1] = 0x04;
+  buf[2] = static_cast<uint8_t>(function);
+  buf[3] = 0x00;
+  buf[4] = 0x00;
+  buf[5] = 0x00;
+  return kApciSize;
+}
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
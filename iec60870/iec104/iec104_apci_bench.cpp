@@ -0,0 +1,99 @@
+#include "iec104_apci.h"
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace QIEC60870::p104;
+
+namespace {
+/// apdus per decode iteration, enough to amortise the per-call overhead
+const int kApdusPerStream = 64;
+
+enum ApduKind { kIFrame, kSFrame, kUFrame };
+
+std::vector<uint8_t> makeStream(int kind, size_t asduSize) {
+  std::vector<uint8_t> asdu(asduSize);
+  for (size_t i = 0; i < asdu.size(); ++i) {
+    asdu[i] = static_cast<uint8_t>(i);
+  }
+  std::vector<uint8_t> stream(kApdusPerStream * kMaxApduSize);
+  size_t size = 0;
+  for (int i = 0; i < kApdusPerStream; ++i) {
+    uint8_t *p = stream.data() + size;
+    if (kind == kIFrame) {
+      size += encodeIFrame(static_cast<uint16_t>(i), 0, asdu.data(),
+                           asdu.size(), p, kMaxApduSize);
+    } else if (kind == kSFrame) {
+      size += encodeSFrame(static_cast<uint16_t>(i), p, kMaxApduSize);
+    } else {
+      size += encodeUFrame(UFunction::kTestFrAct, p, kMaxApduSize);
+    }
+  }
+  stream.resize(size);
+  return stream;
+}
+
+void setCounters(benchmark::State &state, int64_t apdus, int64_t bytes) {
+  state.SetItemsProcessed(state.iterations() * apdus);
+  state.SetBytesProcessed(state.iterations() * bytes);
+}
+} // namespace
+
+/// args: asdu size
+static void BM_EncodeIFrame(benchmark::State &state) {
+  std::vector<uint8_t> asdu(state.range(0));
+  uint8_t buf[kMaxApduSize];
+  uint16_t ns = 0;
+  for (auto _ : state) {
+    size_t n = encodeIFrame(ns++, 0, asdu.data(), asdu.size(), buf,
+                            sizeof(buf));
+    benchmark::DoNotOptimize(n);
+    benchmark::ClobberMemory();
+  }
+  setCounters(state, 1, kApciSize + asdu.size());
+}
+
+/// args: apdu kind, asdu size, chunk size (0 for the whole stream at once)
+static void BM_DecodeStream(benchmark::State &state) {
+  auto stream = makeStream(state.range(0), state.range(1));
+  size_t chunk = state.range(2) == 0 ? stream.size() : state.range(2);
+  ApduCodec codec;
+  size_t apdus = 0;
+  auto count = [&apdus](const ApduView &view) {
+    benchmark::DoNotOptimize(view.asdu());
+    ++apdus;
+  };
+  for (auto _ : state) {
+    for (size_t i = 0; i < stream.size(); i += chunk) {
+      codec.decodeStream(stream.data() + i,
+                         std::min(chunk, stream.size() - i), count);
+    }
+  }
+  if (apdus != static_cast<size_t>(state.iterations()) * kApdusPerStream) {
+    state.SkipWithError("apdus lost");
+  }
+  setCounters(state, kApdusPerStream, stream.size());
+}
+
+static void AsduSizes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"asdu"});
+  for (int asduSize : {16, 64, static_cast<int>(kMaxAsduLength)}) {
+    b->Args({asduSize});
+  }
+}
+
+static void ApduKindsAndChunks(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"kind", "asdu", "chunk"});
+  for (int chunk : {0, 1, 16, 1460}) {
+    b->Args({kSFrame, 0, chunk});
+    b->Args({kUFrame, 0, chunk});
+    for (int asduSize : {16, 64, static_cast<int>(kMaxAsduLength)}) {
+      b->Args({kIFrame, asduSize, chunk});
+    }
+  }
+}
+
+BENCHMARK(BM_EncodeIFrame)->Apply(AsduSizes);
+BENCHMARK(BM_DecodeStream)->Apply(ApduKindsAndChunks);
@@ -0,0 +1,188 @@
+#include "iec104_apci.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+namespace {
+const std::vector<uint8_t> kAsdu = {0x64, 0x01, 0x06, 0x00,
+                                    0x01, 0x00, 0x00, 0x00, 0x00, 0x14};
+
+std::vector<uint8_t> iFrame(uint16_t ns, uint16_t nr) {
+  std::vector<uint8_t> raw(kMaxApduSize);
+  raw.resize(encodeIFrame(ns, nr, kAsdu.data(), kAsdu.size(), raw.data(),
+                          raw.size()));
+  return raw;
+}
+
+struct Collector {
+  void operator()(const ApduView &view) {
+    apdus.push_back(std::vector<uint8_t>(view.raw(),
+                                         view.raw() + view.rawSize()));
+  }
+  std::vector<std::vector<uint8_t>> apdus;
+};
+} // namespace
+
+TEST(Apci, encode_iframe) {
+  auto raw = iFrame(3, 0x7fff);
+  EXPECT_THAT(raw, ElementsAre(0x68, 0x0e, 0x06, 0x00, 0xfe, 0xff, 0x64, 0x01,
+                               0x06, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00,
+                               0x14));
+  /// sequence numbers wrap modulo 32768
+  EXPECT_EQ(iFrame(kSequenceModulo + 3, 0), iFrame(3, 0));
+}
+
+TEST(Apci, encode_iframe_checks_sizes) {
+  uint8_t buf[kMaxApduSize];
+  EXPECT_EQ(encodeIFrame(0, 0, kAsdu.data(), 0, buf, sizeof(buf)), 0u);
+  EXPECT_EQ(encodeIFrame(0, 0, buf, kMaxAsduLength + 1, buf, sizeof(buf)), 0u);
+  EXPECT_EQ(encodeIFrame(0, 0, kAsdu.data(), kAsdu.size(), buf, 15), 0u);
+  EXPECT_EQ(encodeIFrame(0, 0, kAsdu.data(), kAsdu.size(), buf, 16), 16u);
+}
+
+TEST(Apci, encode_iframe_header_in_place) {
+  uint8_t buf[kMaxApduSize];
+  std::copy(kAsdu.begin(), kAsdu.end(), buf + kApciSize);
+  size_t n = encodeIFrameHeader(3, 0x7fff, kAsdu.size(), buf);
+  EXPECT_EQ(std::vector<uint8_t>(buf, buf + n), iFrame(3, 0x7fff));
+}
+
+TEST(Apci, encode_sframe_and_uframe) {
+  uint8_t buf[kApciSize];
+  EXPECT_EQ(encodeSFrame(2, buf, 5), 0u);
+  ASSERT_EQ(encodeSFrame(0x1234, buf, sizeof(buf)), kApciSize);
+  EXPECT_THAT(buf, ElementsAre(0x68, 0x04, 0x01, 0x00, 0x68, 0x24));
+  ASSERT_EQ(encodeUFrame(UFunction::kStartDtAct, buf, sizeof(buf)), kApciSize);
+  EXPECT_THAT(buf, ElementsAre(0x68, 0x04, 0x07, 0x00, 0x00, 0x00));
+}
+
+TEST(Apci, decode_frame_views) {
+  std::vector<uint8_t> data = iFrame(5, 7);
+  data.insert(data.end(), {0x68, 0x04, 0x01, 0x00, 0x0a, 0x00});
+  data.insert(data.end(), {0x68, 0x04, 0x43, 0x00, 0x00, 0x00});
+
+  std::vector<ApduView> views;
+  ApduCodec codec;
+  auto keep = [&views](const ApduView &view) { views.push_back(view); };
+  EXPECT_EQ(codec.decodeStream(data, keep), 3u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNoError);
+  ASSERT_EQ(views.size(), 3u);
+
+  EXPECT_EQ(views[0].type(), FrameType::kIFrame);
+  EXPECT_EQ(views[0].sendSequence(), 5);
+  EXPECT_EQ(views[0].receiveSequence(), 7);
+  EXPECT_EQ(views[0].raw(), data.data());
+  EXPECT_EQ(std::vector<uint8_t>(views[0].asdu(),
+                                 views[0].asdu() + views[0].asduSize()),
+            kAsdu);
+
+  EXPECT_TRUE(views[1].isSFrame());
+  EXPECT_EQ(views[1].receiveSequence(), 5);
+  EXPECT_EQ(views[1].asduSize(), 0u);
+
+  EXPECT_TRUE(views[2].isUFrame());
+  EXPECT_EQ(views[2].uFunction(), UFunction::kTestFrAct);
+}
+
+TEST(Apci, decode_stream_in_any_chunks) {
+  std::vector<uint8_t> data;
+  for (uint16_t ns = 0; ns < 4; ++ns) {
+    auto raw = iFrame(ns, 0);
+    data.insert(data.end(), raw.begin(), raw.end());
+    data.insert(data.end(), {0x68, 0x04, 0x01, 0x00, 0x02, 0x00});
+  }
+
+  for (size_t chunk = 1; chunk <= data.size(); ++chunk) {
+    ApduCodec codec;
+    Collector collector;
+    for (size_t i = 0; i < data.size(); i += chunk) {
+      codec.decodeStream(data.data() + i, std::min(chunk, data.size() - i),
+                         collector);
+      EXPECT_NE(codec.error(), ApduParseErr::kBadFormat) << chunk;
+    }
+    EXPECT_EQ(codec.error(), ApduParseErr::kNoError) << chunk;
+    ASSERT_EQ(collector.apdus.size(), 8u) << chunk;
+    EXPECT_EQ(collector.apdus[6], iFrame(3, 0)) << chunk;
+  }
+}
+
+TEST(Apci, decode_partial_apdu_needs_more_data) {
+  auto raw = iFrame(1, 1);
+  ApduCodec codec;
+  Collector collector;
+  EXPECT_EQ(codec.decodeStream(raw.data(), 1, collector), 0u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNeedMoreData);
+  EXPECT_EQ(codec.decodeStream(raw.data() + 1, 5, collector), 0u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNeedMoreData);
+  EXPECT_EQ(codec.decodeStream(raw.data() + 6, raw.size() - 6, collector), 1u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNoError);
+
+  codec.decodeStream(raw.data(), 3, collector);
+  codec.reset();
+  EXPECT_EQ(codec.decodeStream(raw, collector), 1u);
+  ASSERT_EQ(collector.apdus.size(), 2u);
+}
+
+TEST(Apci, decode_empty_chunks) {
+  auto raw = iFrame(1, 1);
+  ApduCodec codec;
+  Collector collector;
+  EXPECT_EQ(codec.decodeStream(std::vector<uint8_t>(), collector), 0u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNoError);
+  /// an empty chunk keeps the cut apdu
+  codec.decodeStream(raw.data(), 3, collector);
+  EXPECT_EQ(codec.decodeStream(std::vector<uint8_t>(), collector), 0u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kNeedMoreData);
+  EXPECT_EQ(codec.decodeStream(raw.data() + 3, raw.size() - 3, collector), 1u);
+  ASSERT_EQ(collector.apdus.size(), 1u);
+  EXPECT_EQ(collector.apdus[0], raw);
+}
+
+TEST(Apci, decode_rejects_malformed_apdus) {
+  struct TestCase {
+    std::vector<uint8_t> data;
+    std::string name;
+  };
+  std::vector<TestCase> cases = {
+      {{0x67, 0x04, 0x01, 0x00, 0x00, 0x00}, "start"},
+      {{0x68, 0x03, 0x01, 0x00, 0x00}, "too short"},
+      {{0x68, 0xfe}, "too long"},
+      {{0x68, 0x04, 0x00, 0x00, 0x00, 0x00}, "I frame without asdu"},
+      {{0x68, 0x05, 0x01, 0x00, 0x00, 0x00, 0x00}, "S frame with asdu"},
+      {{0x68, 0x04, 0x01, 0x00, 0x01, 0x00}, "N(R) low bit"},
+      {{0x68, 0x04, 0x0f, 0x00, 0x00, 0x00}, "two U functions"},
+      {{0x68, 0x04, 0x03, 0x00, 0x00, 0x00}, "no U function"}};
+
+  for (const auto &test : cases) {
+    ApduCodec codec;
+    Collector collector;
+    EXPECT_EQ(codec.decodeStream(test.data, collector), 0u) << test.name;
+    EXPECT_EQ(codec.error(), ApduParseErr::kBadFormat) << test.name;
+
+    /// the same through the kept bytes
+    ApduCodec split;
+    split.decodeStream(test.data.data(), 1, collector);
+    split.decodeStream(test.data.data() + 1, test.data.size() - 1, collector);
+    EXPECT_EQ(split.error(), ApduParseErr::kBadFormat) << test.name;
+    EXPECT_TRUE(collector.apdus.empty()) << test.name;
+  }
+}
+
+TEST(Apci, decode_stops_at_bad_apdu) {
+  std::vector<uint8_t> data = {0x68, 0x04, 0x07, 0x00, 0x00, 0x00,
+                               0x00, 0x68, 0x04, 0x0b, 0x00, 0x00,
+                               0x00, 0x00};
+  ApduCodec codec;
+  Collector collector;
+  EXPECT_EQ(codec.decodeStream(data, collector), 1u);
+  EXPECT_EQ(codec.error(), ApduParseErr::kBadFormat);
+  EXPECT_EQ(codec.decodeStream(data, collector), 0u);
+  codec.reset();
+  EXPECT_EQ(codec.decodeStream(data.data(), 6, collector), 1u);
+}
@@ -0,0 +1,187 @@
+#ifndef IEC104_LINK_TIMERS_H
+#define IEC104_LINK_TIMERS_H
+
+#include <cstdint>
+#include <functional>
+
+#include "iec104_apci.h"
+#include "iec104_window.h"
+#include "iec_timer_wheel.h"
+
+namespace QIEC60870 {
+namespace p104 {
+
+/**
+ * @brief the 104 timeouts, the defaults of IEC 60870-5-104 clause 9.6
+ */
+struct TimerParameters {
+  /// t1, for the ack of a sent I frame or TESTFR act
+  int64_t t1Ms = 15000;
+  /// t2, the longest a received I frame waits for an ack, t2 < t1
+  int64_t t2Ms = 10000;
+  /// t3, idle time before a TESTFR act
+  int64_t t3Ms = 20000;
+};
+
+enum class LinkTimer {
+  kT1 = 1,
+  kT2 = 2,
+  kT3 = 3,
+};
+
+/**
+ * @brief The t1, t2 and t3 timers of one 104 link on a TimerWheel shared by
+ * all links of the thread. it sees every apdu received and sent and arms,
+ * restarts and stops the timers as clause 9.6 says, the owner only acts on
+ * expiry:
+ *   kT1 - close the link
+ *   kT2 - send an S frame, Window::acknowledge()
+ *   kT3 - send a TESTFR act
+ * the sequences are those of the Window of the link, which sees every apdu
+ * first, so the two never disagree:
+ *   if (window.received(apdu) != WindowErr::kNoError) { close }
+ *   timers.received(apdu);
+ * re-arming on every frame is a list move on the wheel, no allocation and
+ * no clock read, the wheel has the time
+ */
+class LinkTimers {
+public:
+  typedef std::function<void(LinkTimer)> ExpiryHandler;
+
+  LinkTimers(TimerWheel &wheel, const Window &window,
+             const TimerParameters &parameters = TimerParameters())
+      : wheel_(wheel), window_(window), parameters_(parameters) {
+    t1_.setCallback([this]() { expired_(LinkTimer::kT1); });
+    t1Test_.setCallback([this]() { expired_(LinkTimer::kT1); });
+    t2_.setCallback([this]() { expired_(LinkTimer::kT2); });
+    t3_.setCallback([this]() { expired_(LinkTimer::kT3); });
+  }
+  LinkTimers(const LinkTimers &) = delete;
+  LinkTimers &operator=(const LinkTimers &) = delete;
+
+  /**
+   * @brief called on expiry, the timer is no longer armed then
+   *
+   * @param handler
+   */
+  void onExpiry(ExpiryHandler handler) { handler_ = std::move(handler); }
+  /**
+   * @brief for the links started after the call
+   *
+   * @param parameters
+   */
+  void setParameters(const TimerParameters &parameters) {
+    parameters_ = parameters;
+  }
+  const TimerParameters &parameters() const { return parameters_; }
+
+  /**
+   * @brief the link is up, t3 runs
+   */
+  void start() {
+    stop();
+    wheel_.schedule(t3_, parameters_.t3Ms);
+  }
+  void stop() {
+    t1_.cancel();
+    t1Test_.cancel();
+    t2_.cancel();
+    t3_.cancel();
+  }
+
+  /**
+   * @brief a well formed apdu came in, after Window::received() took it:
+   * t3 restarts, an I frame starts t2 unless an earlier one is still
+   * unacknowledged, an ack of all sent I frames stops t1, of some restarts
+   * it, a TESTFR con stops its t1
+   *
+   * @param apdu
+   */
+  void received(const ApduView &apdu) {
+    wheel_.schedule(t3_, parameters_.t3Ms);
+    switch (apdu.type()) {
+    case FrameType::kIFrame:
+      if (!t2_.isArmed()) {
+        wheel_.schedule(t2_, parameters_.t2Ms);
+      }
+      acknowledged_();
+      break;
+    case FrameType::kSFrame:
+      acknowledged_();
+      break;
+    case FrameType::kUFrame:
+      if (apdu.uFunction() == UFunction::kTestFrCon) {
+        t1Test_.cancel();
+      }
+      break;
+    }
+  }
+
+  /**
+   * @brief an apdu was queued, after Window::sent() or transmit() took it:
+   * an I or S frame acks what was received and
+   * stops t2, an I frame starts t1 unless it runs, a TESTFR act starts its
+   * own t1
+   *
+   * @param apdu
+   */
+  void sent(const ApduView &apdu) {
+    switch (apdu.type()) {
+    case FrameType::kIFrame:
+      if (!t1_.isArmed()) {
+        wheel_.schedule(t1_, parameters_.t1Ms);
+      }
+      t2_.cancel();
+      break;
+    case FrameType::kSFrame:
+      t2_.cancel();
+      break;
+    case FrameType::kUFrame:
+      if (apdu.uFunction() == UFunction::kTestFrAct) {
+        wheel_.schedule(t1Test_, parameters_.t1Ms);
+      }
+      break;
+    }
+  }
+
+  bool isArmed(LinkTimer timer) const {
+    switch (timer) {
+    case LinkTimer::kT1:
+      return t1_.isArmed() || t1Test_.isArmed();
+    case LinkTimer::kT2:
+      return t2_.isArmed();
+    case LinkTimer::kT3:
+      return t3_.isArmed();
+    }
+    return false;
+  }
+
+private:
+  void acknowledged_() {
+    if (window_.outstanding() == 0) {
+      t1_.cancel();
+    } else if (window_.newlyAcknowledged() != 0 && t1_.isArmed()) {
+      wheel_.schedule(t1_, parameters_.t1Ms);
+    }
+  }
+
+  void expired_(LinkTimer timer) {
+    if (handler_) {
+      handler_(timer);
+    }
+  }
+
+  TimerWheel &wheel_;
+  const Window &window_;
+  TimerParameters parameters_;
+  ExpiryHandler handler_;
+  Timer t1_;
+  Timer t1Test_;
+  Timer t2_;
+  Timer t3_;
+};
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
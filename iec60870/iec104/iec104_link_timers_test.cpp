@@ -0,0 +1,152 @@
+#include "iec104_link_timers.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870;
+using namespace QIEC60870::p104;
+
+namespace {
+class LinkTimersTest : public Test {
+protected:
+  LinkTimersTest() : timers(wheel, window) {
+    timers.onExpiry([this](LinkTimer timer) { expired.push_back(timer); });
+    timers.start();
+  }
+
+  /// the window takes every frame first, as on a link
+  void receive(const ApduView &apdu) {
+    ASSERT_EQ(window.received(apdu), WindowErr::kNoError);
+    timers.received(apdu);
+  }
+  void send(const ApduView &apdu) {
+    window.sent(apdu);
+    timers.sent(apdu);
+  }
+
+  ApduView iFrame(uint16_t ns, uint16_t nr) {
+    const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                            0x00, 0x00, 0x00, 0x00, 0x14};
+    frames.push_back(std::vector<uint8_t>(kMaxApduSize));
+    size_t n = encodeIFrame(ns, nr, asdu, sizeof(asdu),
+                            frames.back().data(), kMaxApduSize);
+    return ApduView(frames.back().data(), n);
+  }
+  ApduView sFrame(uint16_t nr) {
+    frames.push_back(std::vector<uint8_t>(kApciSize));
+    return ApduView(frames.back().data(),
+                    encodeSFrame(nr, frames.back().data(), kApciSize));
+  }
+  ApduView uFrame(UFunction function) {
+    frames.push_back(std::vector<uint8_t>(kApciSize));
+    return ApduView(frames.back().data(),
+                    encodeUFrame(function, frames.back().data(), kApciSize));
+  }
+
+  TimerWheel wheel;
+  Window window;
+  LinkTimers timers;
+  std::vector<LinkTimer> expired;
+  std::vector<std::vector<uint8_t>> frames;
+};
+} // namespace
+
+TEST_F(LinkTimersTest, t3_restarts_on_every_frame) {
+  EXPECT_TRUE(timers.isArmed(LinkTimer::kT3));
+  wheel.advance(19000);
+  receive(uFrame(UFunction::kTestFrCon));
+  wheel.advance(38999);
+  EXPECT_TRUE(expired.empty());
+  wheel.advance(39000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT3));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT3));
+}
+
+TEST_F(LinkTimersTest, t1_waits_for_testfr_con) {
+  wheel.advance(20000);
+  ASSERT_THAT(expired, ElementsAre(LinkTimer::kT3));
+  send(uFrame(UFunction::kTestFrAct));
+  EXPECT_TRUE(timers.isArmed(LinkTimer::kT1));
+  receive(uFrame(UFunction::kTestFrCon));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT1));
+
+  send(uFrame(UFunction::kTestFrAct));
+  wheel.advance(wheel.now() + 15000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT3, LinkTimer::kT1));
+}
+
+TEST_F(LinkTimersTest, t2_from_the_first_unacked_i_frame) {
+  receive(iFrame(0, 0));
+  wheel.advance(5000);
+  /// a second I frame does not restart t2
+  receive(iFrame(1, 0));
+  EXPECT_EQ(window.receiveSequence(), 2);
+  wheel.advance(10000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT2));
+
+  /// an ack sent stops it
+  receive(iFrame(2, 0));
+  EXPECT_TRUE(timers.isArmed(LinkTimer::kT2));
+  send(sFrame(3));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT2));
+  receive(iFrame(3, 0));
+  send(iFrame(0, 4));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT2));
+}
+
+TEST_F(LinkTimersTest, t1_until_all_i_frames_are_acked) {
+  send(iFrame(0, 0));
+  wheel.advance(10000);
+  send(iFrame(1, 0));
+  send(iFrame(2, 0));
+  /// a partial ack restarts t1, for the oldest frame still unacked
+  receive(sFrame(1));
+  wheel.advance(24999);
+  EXPECT_TRUE(expired.empty());
+  receive(sFrame(3));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT1));
+  wheel.advance(60000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT3));
+
+  send(iFrame(3, 0));
+  wheel.advance(wheel.now() + 15000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT3, LinkTimer::kT1));
+}
+
+TEST_F(LinkTimersTest, a_repeated_ack_does_not_restart_t1) {
+  send(iFrame(0, 0));
+  send(iFrame(1, 0));
+  receive(sFrame(1));
+  EXPECT_EQ(window.outstanding(), 1);
+  wheel.advance(10000);
+  receive(sFrame(1));
+  wheel.advance(15000);
+  EXPECT_THAT(expired, ElementsAre(LinkTimer::kT1));
+}
+
+TEST_F(LinkTimersTest, acks_wrap_modulo_32768) {
+  timers.stop();
+  window.reset();
+  timers.start();
+  send(iFrame(32759, 0));
+  receive(sFrame(32760));
+  for (uint16_t ns = 32760; ns != 5; ns = (ns + 1) % kSequenceModulo) {
+    send(iFrame(ns, 0));
+  }
+  receive(sFrame(2));
+  EXPECT_TRUE(timers.isArmed(LinkTimer::kT1));
+  receive(sFrame(5));
+  EXPECT_FALSE(timers.isArmed(LinkTimer::kT1));
+}
+
+TEST_F(LinkTimersTest, stop_cancels_all) {
+  send(iFrame(0, 0));
+  receive(iFrame(0, 0));
+  timers.stop();
+  EXPECT_EQ(wheel.size(), 0u);
+  wheel.advance(100000);
+  EXPECT_TRUE(expired.empty());
+}
@@ -0,0 +1,146 @@
+#ifndef IEC104_SEND_QUEUE_H
+#define IEC104_SEND_QUEUE_H
+
+#include <sys/uio.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "iec104_apci.h"
+
+namespace QIEC60870 {
+namespace p104 {
+
+/**
+ * @brief The frames waiting to be written to one connection, a fixed ring
+ * of SlotSize byte slots, SendQueue has apdu sized ones. a frame is encoded
+ * straight into its slot:
+ *
+ *   uint8_t *p = queue.reserve();
+ *   if (p != nullptr) {
+ *     queue.commit(encodeUFrame(UFunction::kTestFrAct, p, kMaxApduSize));
+ *   }
+ *
+ * and gather() describes every queued frame as one iovec, so a single
+ * writev()/sendmsg() sends them all. the queue never allocates
+ */
+template <size_t SlotSize> class BasicSendQueue {
+public:
+  /// more than k, the number of unacknowledged I frames, is normally 12
+  enum { kSlots = 32 };
+
+  /**
+   * @brief room for one frame of up to SlotSize bytes
+   *
+   * @return nullptr if the queue is full
+   */
+  uint8_t *reserve() {
+    if (count_ == kSlots) {
+      return nullptr;
+    }
+    return slots_[(head_ + count_) % kSlots].data;
+  }
+
+  /**
+   * @brief queue the frame written to reserve(), 0 queues nothing
+   *
+   * @param size
+   */
+  void commit(size_t size) {
+    if (size == 0 || count_ == kSlots) {
+      return;
+    }
+    slots_[(head_ + count_) % kSlots].size = static_cast<uint16_t>(size);
+    ++count_;
+  }
+
+  /**
+   * @brief copy an encoded frame into the queue
+   *
+   * @param frame
+   * @param size up to SlotSize
+   * @return false if the queue is full
+   */
+  bool push(const uint8_t *frame, size_t size) {
+    uint8_t *p = reserve();
+    if (p == nullptr || size > SlotSize) {
+      return false;
+    }
+    std::memcpy(p, frame, size);
+    commit(size);
+    return true;
+  }
+
+  /**
+   * @brief the queued frames from the oldest on, the first one without the
+   * bytes consume() has already dropped
+   *
+   * @param iov
+   * @param maxIov
+   * @return the number of iovecs filled
+   */
+  size_t gather(struct iovec *iov, size_t maxIov) const {
+    const size_t n = count_ < maxIov ? count_ : maxIov;
+    for (size_t i = 0; i < n; ++i) {
+      const Slot &slot = slots_[(head_ + i) % kSlots];
+      const size_t skip = i == 0 ? offset_ : 0;
+      iov[i].iov_base = const_cast<uint8_t *>(slot.data + skip);
+      iov[i].iov_len = slot.size - skip;
+    }
+    return n;
+  }
+
+  /**
+   * @brief drop the first n queued bytes, after a write that sent them
+   *
+   * @param n
+   */
+  void consume(size_t n) {
+    while (n != 0 && count_ != 0) {
+      const size_t left = slots_[head_].size - offset_;
+      if (n < left) {
+        offset_ += n;
+        return;
+      }
+      n -= left;
+      offset_ = 0;
+      head_ = (head_ + 1) % kSlots;
+      --count_;
+    }
+  }
+
+  void clear() {
+    head_ = 0;
+    count_ = 0;
+    offset_ = 0;
+  }
+
+  /**
+   * @brief number of queued frames, a partly sent one included
+   *
+   * @return
+   */
+  size_t size() const { return count_; }
+  bool empty() const { return count_ == 0; }
+  bool full() const { return count_ == kSlots; }
+
+private:
+  struct Slot {
+    uint8_t data[SlotSize];
+    uint16_t size;
+  };
+
+  Slot slots_[kSlots];
+  size_t head_ = 0;
+  size_t count_ = 0;
+  /// bytes of the oldest frame already sent
+  size_t offset_ = 0;
+};
+
+typedef BasicSendQueue<kMaxApduSize> SendQueue;
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,84 @@
+#include "iec104_send_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+namespace {
+std::vector<uint8_t> gathered(const SendQueue &queue) {
+  iovec iov[SendQueue::kSlots];
+  size_t n = queue.gather(iov, SendQueue::kSlots);
+  std::vector<uint8_t> bytes;
+  for (size_t i = 0; i < n; ++i) {
+    const uint8_t *p = static_cast<const uint8_t *>(iov[i].iov_base);
+    bytes.insert(bytes.end(), p, p + iov[i].iov_len);
+  }
+  return bytes;
+}
+} // namespace
+
+TEST(SendQueue, encode_in_place_and_gather) {
+  SendQueue queue;
+  EXPECT_TRUE(queue.empty());
+  uint8_t *p = queue.reserve();
+  ASSERT_NE(p, nullptr);
+  queue.commit(encodeUFrame(UFunction::kStartDtCon, p, kMaxApduSize));
+  p = queue.reserve();
+  queue.commit(encodeSFrame(1, p, kMaxApduSize));
+  EXPECT_EQ(queue.size(), 2u);
+
+  iovec iov[SendQueue::kSlots];
+  EXPECT_EQ(queue.gather(iov, 1), 1u);
+  EXPECT_EQ(queue.gather(iov, SendQueue::kSlots), 2u);
+  EXPECT_THAT(gathered(queue),
+              ElementsAre(0x68, 0x04, 0x0b, 0x00, 0x00, 0x00, 0x68, 0x04,
+                          0x01, 0x00, 0x02, 0x00));
+}
+
+TEST(SendQueue, consume_partial_writes) {
+  SendQueue queue;
+  const uint8_t a[] = {1, 2, 3};
+  const uint8_t b[] = {4, 5};
+  queue.push(a, sizeof(a));
+  queue.push(b, sizeof(b));
+
+  queue.consume(2);
+  EXPECT_EQ(queue.size(), 2u);
+  EXPECT_THAT(gathered(queue), ElementsAre(3, 4, 5));
+  queue.consume(2);
+  EXPECT_EQ(queue.size(), 1u);
+  EXPECT_THAT(gathered(queue), ElementsAre(5));
+  queue.consume(1);
+  EXPECT_TRUE(queue.empty());
+}
+
+TEST(SendQueue, full_queue_wraps_around) {
+  SendQueue queue;
+  for (size_t i = 0; i < SendQueue::kSlots; ++i) {
+    uint8_t v = static_cast<uint8_t>(i);
+    EXPECT_TRUE(queue.push(&v, 1));
+  }
+  EXPECT_TRUE(queue.full());
+  EXPECT_EQ(queue.reserve(), nullptr);
+  uint8_t v = 0xff;
+  EXPECT_FALSE(queue.push(&v, 1));
+
+  queue.consume(3);
+  for (uint8_t i = 0; i < 3; ++i) {
+    uint8_t w = static_cast<uint8_t>(SendQueue::kSlots + i);
+    EXPECT_TRUE(queue.push(&w, 1));
+  }
+  auto bytes = gathered(queue);
+  ASSERT_EQ(bytes.size(), SendQueue::kSlots);
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    EXPECT_EQ(bytes[i], i + 3);
+  }
+
+  queue.clear();
+  EXPECT_TRUE(queue.empty());
+  EXPECT_NE(queue.reserve(), nullptr);
+}
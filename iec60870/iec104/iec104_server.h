@@ -0,0 +1,692 @@
+#ifndef IEC104_SERVER_H
+#define IEC104_SERVER_H
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "iec104_apci.h"
+#include "iec104_link_timers.h"
+#include "iec104_send_queue.h"
+#include "iec104_window.h"
+
+namespace QIEC60870 {
+namespace p104 {
+
+/// the registered 104 port
+const uint16_t kDefaultPort = 2404;
+
+enum class ServerErr {
+  kNoError = 0,
+  kSocket = 1,
+  kBind = 2,
+  kListen = 3,
+  kEpoll = 4,
+  kIoUring = 5,
+};
+
+struct ServerStats {
+  uint64_t accepted = 0;
+  /// links accepted and closed at once as no descriptor was left for them
+  uint64_t rejected = 0;
+  uint64_t closed = 0;
+  uint64_t apdusReceived = 0;
+  uint64_t bytesReceived = 0;
+  uint64_t bytesSent = 0;
+  /// read() calls that returned data
+  uint64_t readCalls = 0;
+  /// sendmsg() calls, each one writes every queued apdu it can
+  uint64_t writeCalls = 0;
+  /// t1, t2 and t3 expiries, see LinkTimers
+  uint64_t timersExpired = 0;
+};
+
+class Server;
+
+/**
+ * @brief One accepted 104 link: the socket, the apci decoder with the bytes
+ * of an apdu not yet complete, the send queue, the k/w window and the link
+ * timers. only the window queue grows, an idle connection costs about
+ * 8.8 KiB
+ */
+class Connection {
+public:
+  Connection(const Connection &) = delete;
+  Connection &operator=(const Connection &) = delete;
+
+  /**
+   * @brief unique for the lifetime of the server, unlike fd()
+   *
+   * @return
+   */
+  uint64_t id() const { return id_; }
+  int fd() const { return fd_; }
+  bool isOpen() const { return fd_ >= 0; }
+
+  /**
+   * @brief room for one apdu in the send queue, write up to kMaxApduSize
+   * bytes with one of the encode functions and commit() them
+   *
+   * @return nullptr if the send queue is full
+   */
+  uint8_t *reserve() {
+    reserved_ = isOpen() ? sendQueue_.reserve() : nullptr;
+    return reserved_;
+  }
+  void commit(size_t size) {
+    sendQueue_.commit(size);
+    if (size >= kApciSize) {
+      sent_(ApduView(reserved_, size));
+    }
+    markDirty_();
+  }
+  /**
+   * @brief queue an encoded apdu, it is written when the current poll()
+   * round ends, together with everything else queued in the round
+   *
+   * @param apdu
+   * @param size
+   * @return false if the send queue is full or the connection is closed
+   */
+  bool send(const uint8_t *apdu, size_t size) {
+    if (!isOpen() || !sendQueue_.push(apdu, size)) {
+      return false;
+    }
+    if (size >= kApciSize) {
+      sent_(ApduView(apdu, size));
+    }
+    markDirty_();
+    return true;
+  }
+  /**
+   * @brief queue an asdu in the window, it is sent as an I frame with the
+   * next N(S) when fewer than k are unacknowledged, see Window. do not
+   * mix with I frames encoded by the application
+   *
+   * @param asdu
+   * @param size
+   * @return false if the asdu is too long or the connection is closed
+   */
+  bool queueAsdu(const uint8_t *asdu, size_t size) {
+    if (!isOpen() || !window_.queue(asdu, size)) {
+      return false;
+    }
+    markDirty_();
+    return true;
+  }
+  bool sendUFrame(UFunction function) {
+    uint8_t *p = reserve();
+    if (p == nullptr) {
+      return false;
+    }
+    commit(encodeUFrame(function, p, kMaxApduSize));
+    return true;
+  }
+  size_t pendingApdus() const { return sendQueue_.size(); }
+  const LinkTimers &timers() const { return timers_; }
+  const Window &window() const { return window_; }
+
+  /**
+   * @brief close the connection, the close handler runs before close()
+   * returns. the object itself stays valid until the poll() round ends
+   */
+  void close();
+
+  /**
+   * @brief for the application, e.g. its per link state
+   */
+  void setContext(void *context) { context_ = context; }
+  void *context() const { return context_; }
+
+private:
+  friend class Server;
+  Connection(Server *server, TimerWheel &wheel)
+      : server_(server), timers_(wheel, window_) {}
+
+  void markDirty_();
+  void sent_(const ApduView &apdu) {
+    window_.sent(apdu);
+    timers_.sent(apdu);
+  }
+
+  Server *server_;
+  uint64_t id_ = 0;
+  int fd_ = -1;
+  bool dirty_ = false;
+  void *context_ = nullptr;
+  uint8_t *reserved_ = nullptr;
+  ApduCodec codec_;
+  SendQueue sendQueue_;
+  /// before timers_, which reads its sequences
+  Window window_;
+  LinkTimers timers_;
+};
+
+/**
+ * @brief A single threaded 104 front end on linux epoll, edge triggered,
+ * for thousands of mostly idle links per thread.
+ *
+ *   Server server;
+ *   server.onApdu([](Connection &c, const ApduView &apdu) { ... });
+ *   server.listen("0.0.0.0", kDefaultPort);
+ *   server.run();
+ *
+ * every socket is non-blocking and registered once for input and output.
+ * input is read until EAGAIN into one receive buffer shared by all
+ * connections and decoded at once, an apdu cut by the end of a read is
+ * kept in the decoder of its connection, so the shared buffer is free again
+ * after every read. apdus queued during a round, from the handlers or
+ * from outside, are written when the round ends, all apdus of a connection
+ * with one sendmsg(), whose iovecs point into the send queue slots.
+ * a connection is closed on end of stream, a socket error, a malformed
+ * apdu, a sequence error or t1 expiry. asdus queued with queueAsdu() go
+ * out up to k unacknowledged, received I frames are acked every w or on
+ * t2, by one S frame per round at most, see Window. the t1, t2 and t3
+ * timers of all links sit on one TimerWheel, epoll_wait() sleeps until
+ * the next is due, expiry sends the S frame or TESTFR act, see
+ * LinkTimers. the wheel takes application timers too, see timers(). the
+ * handlers may call send() and close() on any connection, the server is
+ * not thread safe. raise RLIMIT_NOFILE for thousands of links
+ */
+class Server {
+public:
+  typedef std::function<void(Connection &, const ApduView &)> ApduHandler;
+  typedef std::function<void(Connection &)> ConnectionHandler;
+
+  /// bytes read per read() call, shared by all connections
+  enum { kReceiveBufferSize = 64 * 1024 };
+  /// events taken per epoll_wait()
+  enum { kMaxEvents = 256 };
+  /// iovecs per sendmsg(), one per apdu
+  enum { kMaxIov = SendQueue::kSlots };
+
+  Server() : wheel_(nowMs()) {}
+  ~Server() {
+    for (auto &connection : connections_) {
+      if (connection->isOpen()) {
+        ::close(connection->fd_);
+      }
+    }
+    if (listenFd_ >= 0) {
+      ::close(listenFd_);
+    }
+    if (reserveFd_ >= 0) {
+      ::close(reserveFd_);
+    }
+    if (epollFd_ >= 0) {
+      ::close(epollFd_);
+    }
+  }
+  Server(const Server &) = delete;
+  Server &operator=(const Server &) = delete;
+
+  /**
+   * @brief called for every decoded apdu, the view is valid until the
+   * handler returns
+   *
+   * @param handler
+   * @return
+   */
+  Server &onApdu(ApduHandler handler) {
+    apduHandler_ = std::move(handler);
+    return *this;
+  }
+  Server &onConnect(ConnectionHandler handler) {
+    connectHandler_ = std::move(handler);
+    return *this;
+  }
+  /**
+   * @brief called once per connection, whoever closes it
+   *
+   * @param handler
+   * @return
+   */
+  Server &onClose(ConnectionHandler handler) {
+    closeHandler_ = std::move(handler);
+    return *this;
+  }
+
+  /**
+   * @brief the timeouts of the links accepted from now on
+   *
+   * @param parameters
+   * @return
+   */
+  Server &setTimerParameters(const TimerParameters &parameters) {
+    timerParameters_ = parameters;
+    return *this;
+  }
+
+  /**
+   * @brief k and w of the links accepted from now on
+   *
+   * @param parameters
+   * @return false if !parameters.isValid(), the parameters are kept
+   */
+  bool setWindowParameters(const WindowParameters &parameters) {
+    if (!parameters.isValid()) {
+      return false;
+    }
+    windowParameters_ = parameters;
+    return true;
+  }
+
+  /**
+   * @brief the wheel of the link timers, for application timers on the
+   * same loop, e.g. a 101 response timeout. poll() advances it to nowMs()
+   *
+   * @return
+   */
+  TimerWheel &timers() { return wheel_; }
+  /**
+   * @brief the monotonic clock of the wheel
+   *
+   * @return
+   */
+  static int64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  }
+
+  /**
+   * @brief
+   *
+   * @param address ipv4 address to bind, e.g. "0.0.0.0"
+   * @param port 0 for any free port, see port()
+   * @param backlog
+   * @return errno tells why on error
+   */
+  ServerErr listen(const char *address, uint16_t port = kDefaultPort,
+                   int backlog = 1024) {
+    if (epollFd_ < 0) {
+      epollFd_ = ::epoll_create1(EPOLL_CLOEXEC);
+      if (epollFd_ < 0) {
+        return ServerErr::kEpoll;
+      }
+    }
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+      errno = EINVAL;
+      return ServerErr::kBind;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return ServerErr::kSocket;
+    }
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+      closeKeepErrno_(fd);
+      return ServerErr::kBind;
+    }
+    if (::listen(fd, backlog) != 0) {
+      closeKeepErrno_(fd);
+      return ServerErr::kListen;
+    }
+    epoll_event event;
+    event.events = EPOLLIN | EPOLLET;
+    event.data.ptr = nullptr;
+    if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+      closeKeepErrno_(fd);
+      return ServerErr::kEpoll;
+    }
+    if (listenFd_ >= 0) {
+      ::close(listenFd_);
+    }
+    listenFd_ = fd;
+    if (reserveFd_ < 0) {
+      reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+    return ServerErr::kNoError;
+  }
+
+  /**
+   * @brief the port listen() bound, 0 if not listening
+   *
+   * @return
+   */
+  uint16_t port() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (listenFd_ < 0 ||
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr *>(&addr), &len) !=
+            0) {
+      return 0;
+    }
+    return ntohs(addr.sin_port);
+  }
+
+  /**
+   * @brief one round: fire the timers due, wait for events or the next
+   * timer, fire the timers due again, accept, read and decode, then write
+   * what was queued
+   *
+   * @param timeoutMs as for epoll_wait(), -1 waits forever
+   * @return the number of events handled, -1 on error
+   */
+  int poll(int timeoutMs) {
+    if (epollFd_ < 0) {
+      errno = EBADF;
+      return -1;
+    }
+    wheel_.advance(nowMs());
+    flush();
+    const int64_t next = wheel_.timeUntilNext();
+    if (next >= 0 && (timeoutMs < 0 || next < timeoutMs)) {
+      timeoutMs = static_cast<int>(next);
+    }
+    epoll_event events[kMaxEvents];
+    int n = ::epoll_wait(epollFd_, events, kMaxEvents, timeoutMs);
+    if (n < 0) {
+      return errno == EINTR ? 0 : -1;
+    }
+    wheel_.advance(nowMs());
+    for (int i = 0; i < n; ++i) {
+      Connection *connection = static_cast<Connection *>(events[i].data.ptr);
+      if (connection == nullptr) {
+        accept_();
+        continue;
+      }
+      if (!connection->isOpen()) {
+        continue;
+      }
+      const uint32_t what = events[i].events;
+      if (what & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+        read_(*connection);
+      }
+      if ((what & EPOLLOUT) && connection->isOpen() &&
+          !connection->sendQueue_.empty()) {
+        connection->markDirty_();
+      }
+    }
+    flush();
+    release_();
+    return n;
+  }
+
+  /**
+   * @brief poll() until stop()
+   *
+   * @param timeoutMs
+   */
+  void run(int timeoutMs = 1000) {
+    running_ = true;
+    while (running_ && poll(timeoutMs) >= 0) {
+    }
+  }
+  void stop() { running_ = false; }
+
+  /**
+   * @brief send what the windows allow and the acks due, then write what
+   * was queued since the last round, poll() does it too
+   */
+  void flush() {
+    for (size_t i = 0; i < dirty_.size(); ++i) {
+      Connection *connection = dirty_[i];
+      if (connection->isOpen()) {
+        /// I frames first, they carry the ack an S frame would
+        connection->window_.transmit(*connection);
+        if (connection->window_.isAckDue()) {
+          connection->window_.acknowledge(*connection);
+        }
+      }
+      connection->dirty_ = false;
+      if (connection->isOpen()) {
+        write_(*connection);
+      }
+    }
+    dirty_.clear();
+  }
+
+  size_t connectionCount() const { return connections_.size() - free_.size(); }
+  const ServerStats &stats() const { return stats_; }
+
+private:
+  friend class Connection;
+
+  void accept_() {
+    for (;;) {
+      int fd = ::accept4(listenFd_, nullptr, nullptr,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
+      if (fd < 0) {
+        if (errno == EINTR || errno == ECONNABORTED) {
+          continue;
+        }
+        if ((errno == EMFILE || errno == ENFILE) && reject_()) {
+          continue;
+        }
+        /// EAGAIN ends the burst. the listen socket is edge triggered, a
+        /// link left in the backlog here would get no event of its own
+        return;
+      }
+      int on = 1;
+      ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+      Connection *connection = allocate_();
+      connection->fd_ = fd;
+      connection->id_ = ++lastId_;
+      connection->window_.setParameters(windowParameters_);
+      connection->timers_.setParameters(timerParameters_);
+      epoll_event event;
+      event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+      event.data.ptr = connection;
+      if (::epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) != 0) {
+        ::close(fd);
+        connection->fd_ = -1;
+        closed_.push_back(connection);
+        continue;
+      }
+      /// t3 only for a link that is watched, one given back keeps none
+      connection->timers_.start();
+      ++stats_.accepted;
+      if (connectHandler_) {
+        connectHandler_(*connection);
+      }
+    }
+  }
+
+  void read_(Connection &connection) {
+    auto dispatch = [this, &connection](const ApduView &apdu) {
+      ++stats_.apdusReceived;
+      if (!connection.isOpen()) {
+        return;
+      }
+      if (connection.window_.received(apdu) != WindowErr::kNoError) {
+        connection.close();
+        return;
+      }
+      connection.timers_.received(apdu);
+      if (!apdu.isUFrame()) {
+        /// an ack may open the window, an I frame may make an ack due
+        connection.markDirty_();
+      }
+      if (apduHandler_) {
+        apduHandler_(connection, apdu);
+      }
+    };
+    while (connection.isOpen()) {
+      ssize_t n = ::read(connection.fd_, rx_, sizeof(rx_));
+      if (n > 0) {
+        ++stats_.readCalls;
+        stats_.bytesReceived += static_cast<uint64_t>(n);
+        connection.codec_.decodeStream(rx_, static_cast<size_t>(n), dispatch);
+        if (connection.codec_.error() == ApduParseErr::kBadFormat) {
+          connection.close();
+        }
+      } else if (n < 0 && errno == EINTR) {
+        continue;
+      } else if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+        return;
+      } else {
+        /// end of stream or a socket error
+        connection.close();
+      }
+    }
+  }
+
+  void write_(Connection &connection) {
+    iovec iov[kMaxIov];
+    while (!connection.sendQueue_.empty()) {
+      msghdr msg;
+      std::memset(&msg, 0, sizeof(msg));
+      msg.msg_iov = iov;
+      msg.msg_iovlen = connection.sendQueue_.gather(iov, kMaxIov);
+      /// sendmsg() is writev() with MSG_NOSIGNAL, a peer reset must not
+      /// raise SIGPIPE
+      ssize_t n = ::sendmsg(connection.fd_, &msg, MSG_NOSIGNAL);
+      if (n >= 0) {
+        ++stats_.writeCalls;
+        stats_.bytesSent += static_cast<uint64_t>(n);
+        connection.sendQueue_.consume(static_cast<size_t>(n));
+      } else if (errno == EINTR) {
+        continue;
+      } else if (errno == EAGAIN || errno == EWOULDBLOCK) {
+        /// the rest goes out on EPOLLOUT
+        return;
+      } else {
+        connection.close();
+        return;
+      }
+    }
+  }
+
+  void close_(Connection &connection) {
+    if (!connection.isOpen()) {
+      return;
+    }
+    /// close() also takes the socket out of the epoll set
+    ::close(connection.fd_);
+    connection.fd_ = -1;
+    connection.timers_.stop();
+    ++stats_.closed;
+    if (closeHandler_) {
+      closeHandler_(connection);
+    }
+    closed_.push_back(&connection);
+  }
+
+  Connection *allocate_() {
+    if (!free_.empty()) {
+      Connection *connection = free_.back();
+      free_.pop_back();
+      return connection;
+    }
+    connections_.emplace_back(new Connection(this, wheel_));
+    Connection *connection = connections_.back().get();
+    connection->timers_.onExpiry([this, connection](LinkTimer timer) {
+      expired_(*connection, timer);
+    });
+    return connection;
+  }
+
+  void expired_(Connection &connection, LinkTimer timer) {
+    ++stats_.timersExpired;
+    switch (timer) {
+    case LinkTimer::kT1:
+      connection.close();
+      break;
+    case LinkTimer::kT2:
+      connection.window_.acknowledge(connection);
+      break;
+    case LinkTimer::kT3:
+      connection.sendUFrame(UFunction::kTestFrAct);
+      break;
+    }
+  }
+
+  /**
+   * @brief recycle the connections closed in the round, only now, events
+   * of the same epoll_wait() may still point to them
+   */
+  void release_() {
+    for (Connection *connection : closed_) {
+      connection->codec_.reset();
+      connection->sendQueue_.clear();
+      connection->window_.reset();
+      connection->context_ = nullptr;
+      connection->dirty_ = false;
+      free_.push_back(connection);
+    }
+    closed_.clear();
+  }
+
+  /**
+   * @brief out of descriptors: free the reserve one, accept the pending
+   * link on it and close it, so the peer sees the close and the backlog
+   * drains instead of waiting for an event that never comes
+   *
+   * @return false if there was no reserve descriptor to free
+   */
+  bool reject_() {
+    if (reserveFd_ < 0) {
+      return false;
+    }
+    ::close(reserveFd_);
+    int fd = ::accept4(listenFd_, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd >= 0) {
+      ::close(fd);
+      ++stats_.rejected;
+    }
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return fd >= 0;
+  }
+
+  static void closeKeepErrno_(int fd) {
+    int err = errno;
+    ::close(fd);
+    errno = err;
+  }
+
+  int epollFd_ = -1;
+  int listenFd_ = -1;
+  /// held to be freed for a link to reject when descriptors run out
+  int reserveFd_ = -1;
+  bool running_ = false;
+  uint64_t lastId_ = 0;
+  ApduHandler apduHandler_;
+  ConnectionHandler connectHandler_;
+  ConnectionHandler closeHandler_;
+  ServerStats stats_;
+  WindowParameters windowParameters_;
+  TimerParameters timerParameters_;
+  /// before connections_, the timers of the connections unlink themselves
+  TimerWheel wheel_;
+
+  /// connections are never deleted before the server, closed ones are
+  /// reused for the next accepted link
+  std::vector<std::unique_ptr<Connection>> connections_;
+  std::vector<Connection *> free_;
+  std::vector<Connection *> closed_;
+  std::vector<Connection *> dirty_;
+  uint8_t rx_[kReceiveBufferSize];
+};
+
+inline void Connection::close() { server_->close_(*this); }
+
+inline void Connection::markDirty_() {
+  if (!dirty_ && isOpen()) {
+    dirty_ = true;
+    server_->dirty_.push_back(this);
+  }
+}
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,381 @@
+#include "iec104_server.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+namespace {
+const uint8_t kStartDtAct[] = {0x68, 0x04, 0x07, 0x00, 0x00, 0x00};
+const uint8_t kStartDtCon[] = {0x68, 0x04, 0x0b, 0x00, 0x00, 0x00};
+
+/// a blocking client socket
+int connectTo(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+/// poll the server until done() or a second has passed
+bool pollUntil(Server &server, const std::function<bool()> &done) {
+  for (int i = 0; i < 100 && !done(); ++i) {
+    server.poll(10);
+  }
+  return done();
+}
+
+/// whatever the client has received so far, without blocking
+std::vector<uint8_t> receiveAvailable(int fd) {
+  std::vector<uint8_t> bytes;
+  uint8_t buf[4096];
+  for (;;) {
+    ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n <= 0) {
+      return bytes;
+    }
+    bytes.insert(bytes.end(), buf, buf + n);
+  }
+}
+
+bool isClosedByPeer(int fd) {
+  pollfd p = {fd, POLLIN, 0};
+  uint8_t ch;
+  return ::poll(&p, 1, 1000) == 1 && ::recv(fd, &ch, 1, 0) == 0;
+}
+
+class ServerTest : public Test {
+protected:
+  void SetUp() override {
+    server.reset(new Server());
+    ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+    ASSERT_NE(server->port(), 0);
+  }
+  void TearDown() override {
+    for (int fd : clients) {
+      ::close(fd);
+    }
+  }
+  int connect() {
+    int fd = connectTo(server->port());
+    clients.push_back(fd);
+    return fd;
+  }
+
+  std::unique_ptr<Server> server;
+  std::vector<int> clients;
+};
+} // namespace
+
+TEST_F(ServerTest, answers_startdt) {
+  server->onApdu([](Connection &connection, const ApduView &apdu) {
+    if (apdu.isUFrame() && apdu.uFunction() == UFunction::kStartDtAct) {
+      connection.sendUFrame(UFunction::kStartDtCon);
+    }
+  });
+  int fd = connect();
+  ASSERT_GE(fd, 0);
+  ASSERT_EQ(::send(fd, kStartDtAct, sizeof(kStartDtAct), 0), 6);
+
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= sizeof(kStartDtCon);
+  }));
+  EXPECT_THAT(received, ElementsAreArray(kStartDtCon));
+  EXPECT_EQ(server->connectionCount(), 1u);
+  EXPECT_EQ(server->stats().apdusReceived, 1u);
+}
+
+TEST_F(ServerTest, many_connections_in_one_thread) {
+  const size_t kLinks = 300;
+  server->onApdu([](Connection &connection, const ApduView &apdu) {
+    if (apdu.isUFrame() && apdu.uFunction() == UFunction::kTestFrAct) {
+      connection.sendUFrame(UFunction::kTestFrCon);
+    }
+  });
+  std::vector<int> fds;
+  for (size_t i = 0; i < kLinks; ++i) {
+    fds.push_back(connect());
+    ASSERT_GE(fds.back(), 0);
+  }
+  ASSERT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == kLinks;
+  }));
+
+  /// every TESTFR act arrives in two pieces
+  const uint8_t testFr[] = {0x68, 0x04, 0x43, 0x00, 0x00, 0x00};
+  for (int fd : fds) {
+    ::send(fd, testFr, 3, 0);
+  }
+  server->poll(10);
+  for (int fd : fds) {
+    ::send(fd, testFr + 3, 3, 0);
+  }
+
+  std::vector<size_t> received(kLinks);
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    bool all = true;
+    for (size_t i = 0; i < kLinks; ++i) {
+      received[i] += receiveAvailable(fds[i]).size();
+      all = all && received[i] == kApciSize;
+    }
+    return all;
+  }));
+  EXPECT_EQ(server->stats().apdusReceived, kLinks);
+}
+
+TEST_F(ServerTest, batches_queued_apdus_into_one_write) {
+  const size_t kApdus = 20;
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  server->onConnect([&](Connection &connection) {
+    for (uint16_t ns = 0; ns < kApdus; ++ns) {
+      uint8_t *p = connection.reserve();
+      ASSERT_NE(p, nullptr);
+      connection.commit(
+          encodeIFrame(ns, 0, asdu, sizeof(asdu), p, kMaxApduSize));
+    }
+    EXPECT_EQ(connection.pendingApdus(), kApdus);
+  });
+  int fd = connect();
+
+  std::vector<uint8_t> received;
+  const size_t expected = kApdus * (kApciSize + sizeof(asdu));
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= expected;
+  }));
+  ASSERT_EQ(received.size(), expected);
+  EXPECT_EQ(server->stats().writeCalls, 1u);
+  EXPECT_EQ(server->stats().bytesSent, expected);
+
+  ApduCodec codec;
+  uint16_t ns = 0;
+  codec.decodeStream(received, [&ns](const ApduView &apdu) {
+    EXPECT_EQ(apdu.sendSequence(), ns++);
+  });
+  EXPECT_EQ(ns, kApdus);
+}
+
+TEST_F(ServerTest, closes_on_malformed_apdu) {
+  uint64_t closedId = 0;
+  server->onClose([&closedId](Connection &connection) {
+    closedId = connection.id();
+  });
+  int fd = connect();
+  ASSERT_TRUE(pollUntil(*server,
+                        [&]() { return server->connectionCount() == 1; }));
+  const uint8_t garbage[] = {0x68, 0x04, 0x0f, 0x00, 0x00, 0x00};
+  ::send(fd, garbage, sizeof(garbage), 0);
+  EXPECT_TRUE(pollUntil(*server, [&]() { return closedId != 0; }));
+  EXPECT_EQ(server->connectionCount(), 0u);
+  EXPECT_TRUE(isClosedByPeer(fd));
+}
+
+TEST_F(ServerTest, peer_close_recycles_the_connection) {
+  size_t closed = 0;
+  std::vector<uint64_t> ids;
+  server->onConnect([&ids](Connection &connection) {
+    ids.push_back(connection.id());
+  });
+  server->onClose([&closed](Connection &) { ++closed; });
+
+  for (int round = 0; round < 2; ++round) {
+    int fd = connectTo(server->port());
+    ASSERT_TRUE(pollUntil(*server,
+                          [&]() { return server->connectionCount() == 1; }));
+    ::close(fd);
+    ASSERT_TRUE(pollUntil(*server,
+                          [&]() { return server->connectionCount() == 0; }));
+  }
+  EXPECT_EQ(closed, 2u);
+  ASSERT_EQ(ids.size(), 2u);
+  EXPECT_NE(ids[0], ids[1]);
+  EXPECT_EQ(server->stats().accepted, 2u);
+  EXPECT_EQ(server->stats().closed, 2u);
+}
+
+TEST_F(ServerTest, rejects_links_when_out_of_descriptors) {
+  int fd = connect();
+  ASSERT_GE(fd, 0);
+  /// no descriptor left above the lowest free one
+  int lowest = ::dup(0);
+  ASSERT_GE(lowest, 0);
+  ::close(lowest);
+  rlimit saved;
+  ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &saved), 0);
+  rlimit limited = saved;
+  limited.rlim_cur = static_cast<rlim_t>(lowest);
+  ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &limited), 0);
+  server->poll(10);
+  ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &saved), 0);
+
+  EXPECT_TRUE(isClosedByPeer(fd));
+  EXPECT_EQ(server->stats().rejected, 1u);
+  EXPECT_EQ(server->stats().accepted, 0u);
+  EXPECT_EQ(server->connectionCount(), 0u);
+
+  /// the listen socket still gets events
+  ASSERT_GE(connect(), 0);
+  EXPECT_TRUE(pollUntil(*server,
+                        [&]() { return server->connectionCount() == 1; }));
+  EXPECT_EQ(server->stats().rejected, 1u);
+}
+
+TEST_F(ServerTest, send_outside_a_round) {
+  Connection *link = nullptr;
+  server->onConnect([&link](Connection &connection) { link = &connection; });
+  int fd = connect();
+  ASSERT_TRUE(pollUntil(*server, [&]() { return link != nullptr; }));
+
+  EXPECT_TRUE(link->send(kStartDtAct, sizeof(kStartDtAct)));
+  server->flush();
+  std::vector<uint8_t> received;
+  pollfd p = {fd, POLLIN, 0};
+  ASSERT_EQ(::poll(&p, 1, 1000), 1);
+  received = receiveAvailable(fd);
+  EXPECT_THAT(received, ElementsAreArray(kStartDtAct));
+
+  link->close();
+  EXPECT_FALSE(link->send(kStartDtAct, sizeof(kStartDtAct)));
+  EXPECT_TRUE(isClosedByPeer(fd));
+}
+
+TEST_F(ServerTest, t3_sends_testfr_and_t1_closes) {
+  TimerParameters parameters;
+  parameters.t1Ms = 100;
+  parameters.t2Ms = 50;
+  parameters.t3Ms = 50;
+  server->setTimerParameters(parameters);
+  bool closed = false;
+  server->onClose([&closed](Connection &) { closed = true; });
+  int fd = connect();
+  ASSERT_TRUE(pollUntil(*server,
+                        [&]() { return server->connectionCount() == 1; }));
+
+  /// idle for t3, a TESTFR act comes, unanswered it closes after t1
+  const uint8_t testFrAct[] = {0x68, 0x04, 0x43, 0x00, 0x00, 0x00};
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return closed;
+  }));
+  EXPECT_THAT(received, ElementsAreArray(testFrAct));
+  EXPECT_EQ(server->stats().timersExpired, 2u);
+  EXPECT_TRUE(isClosedByPeer(fd));
+}
+
+TEST_F(ServerTest, t2_acks_received_i_frames) {
+  TimerParameters parameters;
+  parameters.t2Ms = 30;
+  server->setTimerParameters(parameters);
+  int fd = connect();
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  uint8_t apdu[kMaxApduSize];
+  for (uint16_t ns = 0; ns < 3; ++ns) {
+    size_t n = encodeIFrame(ns, 0, asdu, sizeof(asdu), apdu, sizeof(apdu));
+    ::send(fd, apdu, n, 0);
+  }
+
+  /// one S frame for the three, V(R) 3
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return !received.empty();
+  }));
+  EXPECT_THAT(received, ElementsAre(0x68, 0x04, 0x01, 0x00, 0x06, 0x00));
+  EXPECT_EQ(server->stats().apdusReceived, 3u);
+  EXPECT_EQ(server->stats().timersExpired, 1u);
+}
+
+TEST_F(ServerTest, window_pipelines_queued_asdus) {
+  const size_t kAsdus = 50;
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  WindowParameters parameters;
+  parameters.k = 8;
+  parameters.w = 2;
+  ASSERT_TRUE(server->setWindowParameters(parameters));
+  WindowParameters bad;
+  bad.k = 0;
+  EXPECT_FALSE(server->setWindowParameters(bad));
+  server->onConnect([&](Connection &connection) {
+    for (size_t i = 0; i < kAsdus; ++i) {
+      ASSERT_TRUE(connection.queueAsdu(asdu, sizeof(asdu)));
+    }
+  });
+  int fd = connect();
+
+  /// k frames at a time, the client acks each batch with an S frame
+  ApduCodec codec;
+  uint16_t next = 0;
+  size_t maxBatch = 0;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    size_t batch = 0;
+    codec.decodeStream(receiveAvailable(fd), [&](const ApduView &apdu) {
+      EXPECT_TRUE(apdu.isIFrame());
+      EXPECT_EQ(apdu.sendSequence(), next++);
+      ++batch;
+    });
+    if (batch != 0) {
+      maxBatch = batch > maxBatch ? batch : maxBatch;
+      uint8_t ack[kApciSize];
+      ::send(fd, ack, encodeSFrame(next, ack, sizeof(ack)), 0);
+    }
+    return next == kAsdus;
+  }));
+  EXPECT_GT(maxBatch, 1u);
+  EXPECT_LE(maxBatch, parameters.k);
+
+  /// w I frames received get one S frame
+  uint8_t apdu[kMaxApduSize];
+  for (uint16_t ns = 0; ns < 2; ++ns) {
+    ::send(fd, apdu, encodeIFrame(ns, next, asdu, sizeof(asdu), apdu,
+                                  sizeof(apdu)), 0);
+  }
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return !received.empty();
+  }));
+  EXPECT_THAT(received, ElementsAre(0x68, 0x04, 0x01, 0x00, 0x04, 0x00));
+  EXPECT_EQ(server->stats().timersExpired, 0u);
+}
+
+TEST_F(ServerTest, closes_on_sequence_error) {
+  int fd = connect();
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  uint8_t apdu[kMaxApduSize];
+  ::send(fd, apdu, encodeIFrame(5, 0, asdu, sizeof(asdu), apdu, sizeof(apdu)),
+         0);
+  EXPECT_TRUE(pollUntil(*server,
+                        [&]() { return server->stats().closed == 1; }));
+  EXPECT_TRUE(isClosedByPeer(fd));
+}
@@ -0,0 +1,304 @@
+#ifndef IEC104_URING_H
+#define IEC104_URING_H
+
+#include <linux/io_uring.h>
+#include <linux/time_types.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+namespace QIEC60870 {
+namespace p104 {
+
+/**
+ * @brief A minimal io_uring on the kernel abi of <linux/io_uring.h>, just
+ * what UringServer needs: the submission and completion rings mapped from
+ * the kernel, sqes filled in place, and one ring of provided buffers.
+ * single threaded, no SQPOLL. the server needs Linux 6.0 or later, for the
+ * multishot receive into provided buffers
+ *
+ *   Uring ring;
+ *   if (ring.setup(256) < 0) { no io_uring }
+ *   io_uring_sqe *sqe = ring.sqe();
+ *   sqe->opcode = IORING_OP_NOP;
+ *   ring.submit(1, 1000);
+ *   io_uring_cqe *cqes[16];
+ *   unsigned n = ring.peek(cqes, 16);
+ *   ...
+ *   ring.advance(n);
+ */
+class Uring {
+public:
+  Uring() = default;
+  ~Uring() { close(); }
+  Uring(const Uring &) = delete;
+  Uring &operator=(const Uring &) = delete;
+
+  /**
+   * @brief create the rings
+   *
+   * @param entries sqes, the kernel rounds up to a power of 2, twice as
+   * many cqes
+   * @return 0, or -errno: -EOPNOTSUPP if the kernel can not wait with a
+   * timeout, older than 5.11
+   */
+  int setup(unsigned entries) {
+    close();
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    int fd = static_cast<int>(::syscall(__NR_io_uring_setup, entries, &params));
+    if (fd < 0) {
+      return -errno;
+    }
+    fd_ = fd;
+    if (!(params.features & IORING_FEAT_EXT_ARG)) {
+      close();
+      return -EOPNOTSUPP;
+    }
+    sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    cqRingSize_ =
+        params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const bool single = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (single && cqRingSize_ > sqRingSize_) {
+      sqRingSize_ = cqRingSize_;
+    }
+    sqRing_ = map_(sqRingSize_, IORING_OFF_SQ_RING);
+    cqRing_ = single ? sqRing_ : map_(cqRingSize_, IORING_OFF_CQ_RING);
+    sqesSize_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe *>(map_(sqesSize_, IORING_OFF_SQES));
+    if (sqRing_ == nullptr || cqRing_ == nullptr || sqes_ == nullptr) {
+      const int err = errno;
+      close();
+      return -err;
+    }
+
+    uint8_t *sq = static_cast<uint8_t *>(sqRing_);
+    sqHead_ = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    sqTail_ = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    sqMask_ = *reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    sqEntries_ = params.sq_entries;
+    /// sqe i always sits in slot i, the array is the identity
+    unsigned *array = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    for (unsigned i = 0; i < sqEntries_; ++i) {
+      array[i] = i;
+    }
+    sqeTail_ = *sqTail_;
+
+    uint8_t *cq = static_cast<uint8_t *>(cqRing_);
+    cqHead_ = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    cqTail_ = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    cqMask_ = *reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    cqes_ = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+    return 0;
+  }
+
+  /**
+   * @brief close the ring, requests in flight are cancelled
+   */
+  void close() {
+    if (fd_ >= 0) {
+      ::close(fd_);
+      fd_ = -1;
+    }
+    unmap_(sqes_, sqesSize_);
+    if (cqRing_ != sqRing_) {
+      unmap_(cqRing_, cqRingSize_);
+    }
+    unmap_(sqRing_, sqRingSize_);
+    sqes_ = nullptr;
+    cqRing_ = nullptr;
+    sqRing_ = nullptr;
+    unmap_(bufferRing_, bufferRingSize_);
+    bufferRing_ = nullptr;
+  }
+
+  bool isOpen() const { return fd_ >= 0; }
+
+  /**
+   * @brief the next sqe, zeroed, handed to the kernel by the next submit()
+   *
+   * @return nullptr if every sqe is prepared and not yet submitted
+   */
+  io_uring_sqe *sqe() {
+    if (sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE) >= sqEntries_) {
+      return nullptr;
+    }
+    io_uring_sqe *sqe = &sqes_[sqeTail_ & sqMask_];
+    ++sqeTail_;
+    std::memset(sqe, 0, sizeof(*sqe));
+    return sqe;
+  }
+
+  /**
+   * @brief how many sqe() can hand out before the next submit()
+   *
+   * @return
+   */
+  unsigned available() const {
+    return sqEntries_ - (sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE));
+  }
+
+  /**
+   * @brief submit the prepared sqes, then wait for waitFor completions or
+   * until timeoutMs passed, one io_uring_enter()
+   *
+   * @param waitFor 0 does not wait
+   * @param timeoutMs -1 waits forever
+   * @return the number of sqes submitted, or -errno: -ETIME when the wait
+   * timed out, -EBUSY when the completion ring is to be drained first
+   */
+  int submit(unsigned waitFor = 0, int timeoutMs = -1) {
+    __atomic_store_n(sqTail_, sqeTail_, __ATOMIC_RELEASE);
+    const unsigned toSubmit =
+        sqeTail_ - __atomic_load_n(sqHead_, __ATOMIC_ACQUIRE);
+    unsigned flags = 0;
+    const void *arg = nullptr;
+    size_t argSize = _NSIG / 8;
+    __kernel_timespec ts;
+    io_uring_getevents_arg ext;
+    if (waitFor != 0) {
+      flags |= IORING_ENTER_GETEVENTS;
+      if (timeoutMs >= 0) {
+        ts.tv_sec = timeoutMs / 1000;
+        ts.tv_nsec = (timeoutMs % 1000) * 1000000LL;
+        std::memset(&ext, 0, sizeof(ext));
+        ext.sigmask_sz = _NSIG / 8;
+        ext.ts = reinterpret_cast<uintptr_t>(&ts);
+        flags |= IORING_ENTER_EXT_ARG;
+        arg = &ext;
+        argSize = sizeof(ext);
+      }
+    } else if (toSubmit == 0) {
+      return 0;
+    }
+    int ret = static_cast<int>(::syscall(__NR_io_uring_enter, fd_, toSubmit,
+                                         waitFor, flags, arg, argSize));
+    return ret < 0 ? -errno : ret;
+  }
+
+  /**
+   * @brief the completions not yet consumed, valid until advance()
+   *
+   * @param cqes
+   * @param max
+   * @return how many were put in cqes
+   */
+  unsigned peek(io_uring_cqe **cqes, unsigned max) const {
+    const unsigned head = *cqHead_;
+    unsigned n = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE) - head;
+    if (n > max) {
+      n = max;
+    }
+    for (unsigned i = 0; i < n; ++i) {
+      cqes[i] = &cqes_[(head + i) & cqMask_];
+    }
+    return n;
+  }
+  /**
+   * @brief hand n completions of peek() back to the kernel
+   *
+   * @param n
+   */
+  void advance(unsigned n) {
+    __atomic_store_n(cqHead_, *cqHead_ + n, __ATOMIC_RELEASE);
+  }
+
+  /**
+   * @brief register a ring for count provided buffers, for the receives
+   * with IOSQE_BUFFER_SELECT and group. one group per Uring
+   *
+   * @param count a power of 2, at most 32768
+   * @param group
+   * @return 0 or -errno, -EINVAL before Linux 5.19
+   */
+  int setupBufferRing(unsigned count, uint16_t group) {
+    bufferRingSize_ = count * sizeof(io_uring_buf);
+    void *p = ::mmap(nullptr, bufferRingSize_, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p == MAP_FAILED) {
+      return -errno;
+    }
+    io_uring_buf_reg reg;
+    std::memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = reinterpret_cast<uintptr_t>(p);
+    reg.ring_entries = count;
+    reg.bgid = group;
+    if (::syscall(__NR_io_uring_register, fd_, IORING_REGISTER_PBUF_RING, &reg,
+                  1) != 0) {
+      const int err = errno;
+      ::munmap(p, bufferRingSize_);
+      return -err;
+    }
+    /// the bufs of io_uring_buf_ring sit 8 bytes off in c++, where the
+    /// empty struct of __DECLARE_FLEX_ARRAY takes room, so plain io_uring_buf
+    bufferRing_ = static_cast<io_uring_buf *>(p);
+    bufferRingTail_ = &static_cast<io_uring_buf_ring *>(p)->tail;
+    bufferMask_ = static_cast<uint16_t>(count - 1);
+    bufferTail_ = 0;
+    return 0;
+  }
+  /**
+   * @brief give a buffer to the kernel, seen after publishBuffers()
+   *
+   * @param data
+   * @param size
+   * @param id in the bits of IORING_CQE_BUFFER_SHIFT of the completion
+   */
+  void provideBuffer(void *data, unsigned size, uint16_t id) {
+    /// the tail overlays resv of buffer 0, which is left alone
+    io_uring_buf *buf = &bufferRing_[bufferTail_ & bufferMask_];
+    buf->addr = reinterpret_cast<uintptr_t>(data);
+    buf->len = size;
+    buf->bid = id;
+    ++bufferTail_;
+  }
+  void publishBuffers() {
+    __atomic_store_n(bufferRingTail_, bufferTail_, __ATOMIC_RELEASE);
+  }
+
+private:
+  void *map_(size_t size, uint64_t offset) {
+    void *p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                     MAP_SHARED | MAP_POPULATE, fd_, static_cast<off_t>(offset));
+    return p == MAP_FAILED ? nullptr : p;
+  }
+  static void unmap_(void *p, size_t size) {
+    if (p != nullptr) {
+      ::munmap(p, size);
+    }
+  }
+
+  int fd_ = -1;
+  void *sqRing_ = nullptr;
+  void *cqRing_ = nullptr;
+  size_t sqRingSize_ = 0;
+  size_t cqRingSize_ = 0;
+  io_uring_sqe *sqes_ = nullptr;
+  size_t sqesSize_ = 0;
+  unsigned *sqHead_ = nullptr;
+  unsigned *sqTail_ = nullptr;
+  unsigned sqMask_ = 0;
+  unsigned sqEntries_ = 0;
+  /// sqes prepared, published to *sqTail_ by submit()
+  unsigned sqeTail_ = 0;
+  unsigned *cqHead_ = nullptr;
+  unsigned *cqTail_ = nullptr;
+  unsigned cqMask_ = 0;
+  io_uring_cqe *cqes_ = nullptr;
+  io_uring_buf *bufferRing_ = nullptr;
+  uint16_t *bufferRingTail_ = nullptr;
+  size_t bufferRingSize_ = 0;
+  uint16_t bufferMask_ = 0;
+  uint16_t bufferTail_ = 0;
+};
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
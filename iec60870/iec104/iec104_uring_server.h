@@ -0,0 +1,878 @@
+#ifndef IEC104_URING_SERVER_H
+#define IEC104_URING_SERVER_H
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "iec101_link_layer_frame.h"
+#include "iec104_apci.h"
+#include "iec104_link_timers.h"
+#include "iec104_send_queue.h"
+#include "iec104_server.h"
+#include "iec104_uring.h"
+#include "iec104_window.h"
+
+namespace QIEC60870 {
+namespace p104 {
+
+/**
+ * @brief the framing of a UringServer: apdus of 104, with the k/w window
+ * and the t1, t2 and t3 timers of each link as on Server
+ */
+struct Iec104Protocol {
+  typedef ApduCodec Codec;
+  typedef ApduView View;
+  enum { kMaxFrameSize = kMaxApduSize };
+
+  static void prepare(Codec &) {}
+  /**
+   * @brief the stream can not be decoded any further, close the link
+   */
+  static bool isBroken(const Codec &codec) {
+    return codec.error() == ApduParseErr::kBadFormat;
+  }
+
+  /**
+   * @brief the Window and LinkTimers of one link, the timers read the
+   * sequences of the window
+   */
+  class Link {
+  public:
+    explicit Link(TimerWheel &wheel) : timers_(wheel, window_) {}
+
+    void onExpiry(LinkTimers::ExpiryHandler handler) {
+      timers_.onExpiry(std::move(handler));
+    }
+    void open(const WindowParameters &window, const TimerParameters &timers) {
+      window_.setParameters(window);
+      window_.reset();
+      timers_.setParameters(timers);
+      timers_.start();
+    }
+    void close() { timers_.stop(); }
+
+    /**
+     * @return false on a sequence error, close the link
+     */
+    bool received(const View &apdu) {
+      if (window_.received(apdu) != WindowErr::kNoError) {
+        return false;
+      }
+      timers_.received(apdu);
+      return true;
+    }
+    void sent(const uint8_t *apdu, size_t size) {
+      if (size >= kApciSize) {
+        const ApduView view(apdu, size);
+        window_.sent(view);
+        timers_.sent(view);
+      }
+    }
+    bool queueAsdu(const uint8_t *asdu, size_t size) {
+      return window_.queue(asdu, size);
+    }
+    /**
+     * @brief the I frames the window allows, then the ack if due
+     */
+    template <typename Sink> void flush(Sink &sink) {
+      window_.transmit(sink);
+      if (window_.isAckDue()) {
+        window_.acknowledge(sink);
+      }
+    }
+    /**
+     * @return false on t1, close the link
+     */
+    template <typename Sink> bool expired(LinkTimer timer, Sink &sink) {
+      switch (timer) {
+      case LinkTimer::kT1:
+        return false;
+      case LinkTimer::kT2:
+        window_.acknowledge(sink);
+        break;
+      case LinkTimer::kT3: {
+        uint8_t *p = sink.reserve();
+        if (p != nullptr) {
+          sink.commit(encodeUFrame(UFunction::kTestFrAct, p, kMaxApduSize));
+        }
+        break;
+      }
+      }
+      return true;
+    }
+
+    const Window &window() const { return window_; }
+    const LinkTimers &timers() const { return timers_; }
+
+  private:
+    /// before timers_, which reads its sequences
+    Window window_;
+    LinkTimers timers_;
+  };
+};
+
+/**
+ * @brief 101 frames tunnelled over tcp, e.g. from a terminal server,
+ * the codec resyncs on line garbage instead of giving up. the 101 link
+ * layer has no window and no timers of the link, the master polls
+ */
+struct Iec101Protocol {
+  typedef p101::LinkLayerFrameCodec Codec;
+  typedef p101::LinkLayerFrameView View;
+  enum { kMaxFrameSize = p101::kMaxFrameLength };
+
+  static void prepare(Codec &codec) { codec.setResyncEnabled(true); }
+  static bool isBroken(const Codec &) { return false; }
+
+  class Link {
+  public:
+    explicit Link(TimerWheel &) {}
+
+    void onExpiry(LinkTimers::ExpiryHandler) {}
+    void open(const WindowParameters &, const TimerParameters &) {}
+    void close() {}
+    bool received(const View &) { return true; }
+    void sent(const uint8_t *, size_t) {}
+    bool queueAsdu(const uint8_t *, size_t) { return false; }
+    template <typename Sink> void flush(Sink &) {}
+    template <typename Sink> bool expired(LinkTimer, Sink &) { return true; }
+  };
+};
+
+struct UringServerStats : ServerStats {
+  /// io_uring_enter() calls, each one hands every prepared sqe over
+  uint64_t submitCalls = 0;
+  uint64_t completions = 0;
+  /// multishot receives that ran out of provided buffers and were rearmed
+  uint64_t bufferShortages = 0;
+};
+
+/**
+ * @brief The io_uring counterpart of Server, for Protocol Iec104Protocol or
+ * Iec101Protocol, on Linux 6.0 or later, see Uring and
+ * QIEC60870_HAS_IO_URING.
+ *
+ * - one multishot accept for the listening socket
+ * - one multishot receive per link, into a ring of kBufferCount buffers
+ *   provided to the kernel once and shared by all links; a buffer is
+ *   decoded as soon as its completion is reaped and handed back
+ * - the frames a link queued in a round go out as one chain of linked
+ *   sends, one send per send queue slot, MSG_WAITALL so that a short send
+ *   breaks the chain instead of reordering the stream. the sends copy from
+ *   the send queue, which is not a registered buffer
+ * - for 104 the k/w window and t1, t2 and t3 of every link run as on
+ *   Server, the timers on one TimerWheel that bounds the wait of poll()
+ *
+ * poll() submits everything prepared in the round and waits for the next
+ * completions with a single io_uring_enter(). the interface, threading and
+ * lifetime rules are those of Server
+ */
+template <typename Protocol> class BasicUringServer {
+public:
+  typedef typename Protocol::Codec Codec;
+  typedef typename Protocol::View View;
+  typedef typename Protocol::Link Link;
+  typedef BasicSendQueue<Protocol::kMaxFrameSize> Queue;
+
+  class Connection {
+  public:
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+
+    uint64_t id() const { return id_; }
+    int fd() const { return fd_; }
+    bool isOpen() const { return open_; }
+
+    /**
+     * @brief room for one frame in the send queue, commit() it
+     *
+     * @return nullptr if the send queue is full
+     */
+    uint8_t *reserve() {
+      reserved_ = open_ ? sendQueue_.reserve() : nullptr;
+      return reserved_;
+    }
+    void commit(size_t size) {
+      sendQueue_.commit(size);
+      link_.sent(reserved_, size);
+      markDirty_();
+    }
+    bool send(const uint8_t *frame, size_t size) {
+      if (!open_ || !sendQueue_.push(frame, size)) {
+        return false;
+      }
+      link_.sent(frame, size);
+      markDirty_();
+      return true;
+    }
+    /**
+     * @brief queue an asdu in the window of a 104 link, see
+     * Connection::queueAsdu() of Server
+     *
+     * @param asdu
+     * @param size
+     * @return false if the asdu is too long, the connection is closed, or
+     * the link is 101
+     */
+    bool queueAsdu(const uint8_t *asdu, size_t size) {
+      if (!open_ || !link_.queueAsdu(asdu, size)) {
+        return false;
+      }
+      markDirty_();
+      return true;
+    }
+    size_t pendingFrames() const { return sendQueue_.size(); }
+    /**
+     * @brief the window and timers of a 104 link
+     *
+     * @return
+     */
+    const Link &link() const { return link_; }
+
+    /**
+     * @brief the close handler runs before close() returns, the socket is
+     * shut down at once and closed when its last request has completed
+     */
+    void close() { server_->close_(*this); }
+
+    void setContext(void *context) { context_ = context; }
+    void *context() const { return context_; }
+
+  private:
+    friend class BasicUringServer;
+    Connection(BasicUringServer *server, TimerWheel &wheel)
+        : server_(server), link_(wheel) {}
+
+    void markDirty_() {
+      if (!dirty_ && open_) {
+        dirty_ = true;
+        server_->dirty_.push_back(this);
+      }
+    }
+
+    BasicUringServer *server_;
+    uint64_t id_ = 0;
+    int fd_ = -1;
+    bool open_ = false;
+    bool dirty_ = false;
+    bool receiving_ = false;
+    /// sends of the chain in flight
+    size_t sending_ = 0;
+    void *context_ = nullptr;
+    uint8_t *reserved_ = nullptr;
+    Codec codec_;
+    Queue sendQueue_;
+    Link link_;
+  };
+
+  typedef std::function<void(Connection &, const View &)> FrameHandler;
+  typedef std::function<void(Connection &)> ConnectionHandler;
+
+  /// provided receive buffers, a power of 2
+  enum { kBufferCount = 1024 };
+  enum { kBufferSize = 4096 };
+  enum { kQueueDepth = 4096 };
+  /// completions reaped per batch
+  enum { kMaxCompletions = 256 };
+
+  BasicUringServer() : wheel_(Server::nowMs()) {}
+  ~BasicUringServer() {
+    /// first, no completion may write into the buffers any more
+    ring_.close();
+    for (auto &connection : connections_) {
+      if (connection->fd_ >= 0) {
+        ::close(connection->fd_);
+      }
+    }
+    if (listenFd_ >= 0) {
+      ::close(listenFd_);
+    }
+    if (reserveFd_ >= 0) {
+      ::close(reserveFd_);
+    }
+    std::free(buffers_);
+  }
+  BasicUringServer(const BasicUringServer &) = delete;
+  BasicUringServer &operator=(const BasicUringServer &) = delete;
+
+  BasicUringServer &onFrame(FrameHandler handler) {
+    frameHandler_ = std::move(handler);
+    return *this;
+  }
+  BasicUringServer &onConnect(ConnectionHandler handler) {
+    connectHandler_ = std::move(handler);
+    return *this;
+  }
+  BasicUringServer &onClose(ConnectionHandler handler) {
+    closeHandler_ = std::move(handler);
+    return *this;
+  }
+
+  /**
+   * @brief the timeouts of the 104 links accepted from now on
+   *
+   * @param parameters
+   * @return
+   */
+  BasicUringServer &setTimerParameters(const TimerParameters &parameters) {
+    timerParameters_ = parameters;
+    return *this;
+  }
+  /**
+   * @brief k and w of the 104 links accepted from now on
+   *
+   * @param parameters
+   * @return false if !parameters.isValid(), the parameters are kept
+   */
+  bool setWindowParameters(const WindowParameters &parameters) {
+    if (!parameters.isValid()) {
+      return false;
+    }
+    windowParameters_ = parameters;
+    return true;
+  }
+  /**
+   * @brief the wheel of the link timers, for application timers on the
+   * same loop. poll() advances it to Server::nowMs()
+   *
+   * @return
+   */
+  TimerWheel &timers() { return wheel_; }
+
+  /**
+   * @brief
+   *
+   * @param address ipv4 address to bind
+   * @param port 0 for any free port, see port()
+   * @param backlog
+   * @return kIoUring if io_uring can not be set up, e.g. an old kernel or a
+   * sandbox that forbids it. errno tells why on error
+   */
+  ServerErr listen(const char *address, uint16_t port = kDefaultPort,
+                   int backlog = 1024) {
+    if (!ring_.isOpen() && !setupRing_()) {
+      return ServerErr::kIoUring;
+    }
+    sockaddr_in addr;
+    std::memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_port = htons(port);
+    if (::inet_pton(AF_INET, address, &addr.sin_addr) != 1) {
+      errno = EINVAL;
+      return ServerErr::kBind;
+    }
+    int fd = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0) {
+      return ServerErr::kSocket;
+    }
+    int on = 1;
+    ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if (::bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0 ||
+        ::listen(fd, backlog) != 0) {
+      int err = errno;
+      ::close(fd);
+      errno = err;
+      return ServerErr::kBind;
+    }
+    if (listenFd_ >= 0) {
+      /// ends the accept still armed on it, its completions are stale
+      ::shutdown(listenFd_, SHUT_RDWR);
+      ::close(listenFd_);
+    }
+    listenFd_ = fd;
+    ++listenGeneration_;
+    if (reserveFd_ < 0) {
+      reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    }
+    armAccept_();
+    return ServerErr::kNoError;
+  }
+
+  uint16_t port() const {
+    sockaddr_in addr;
+    socklen_t len = sizeof(addr);
+    if (listenFd_ < 0 ||
+        ::getsockname(listenFd_, reinterpret_cast<sockaddr *>(&addr), &len) !=
+            0) {
+      return 0;
+    }
+    return ntohs(addr.sin_port);
+  }
+
+  /**
+   * @brief one round: fire the timers due, submit, wait for completions or
+   * the next timer, fire the timers due again, handle every completion,
+   * then prepare the sends queued in the round
+   *
+   * @param timeoutMs -1 waits forever
+   * @return the number of completions handled, -1 on error
+   */
+  int poll(int timeoutMs) {
+    if (!ring_.isOpen()) {
+      errno = EBADF;
+      return -1;
+    }
+    wheel_.advance(Server::nowMs());
+    flush();
+    const int64_t next = wheel_.timeUntilNext();
+    if (next >= 0 && (timeoutMs < 0 || next < timeoutMs)) {
+      timeoutMs = static_cast<int>(next);
+    }
+    ++stats_.submitCalls;
+    const int ret = ring_.submit(1, timeoutMs);
+    if (ret < 0 && ret != -ETIME && ret != -EINTR && ret != -EBUSY) {
+      errno = -ret;
+      return -1;
+    }
+    wheel_.advance(Server::nowMs());
+    int handled = 0;
+    io_uring_cqe *cqes[kMaxCompletions];
+    for (;;) {
+      unsigned n = ring_.peek(cqes, kMaxCompletions);
+      if (n == 0) {
+        break;
+      }
+      for (unsigned i = 0; i < n; ++i) {
+        complete_(cqes[i]);
+      }
+      ring_.advance(n);
+      handled += static_cast<int>(n);
+    }
+    if (buffersReturned_) {
+      ring_.publishBuffers();
+      buffersReturned_ = false;
+    }
+    stats_.completions += static_cast<uint64_t>(handled);
+    flush();
+    release_();
+    return handled;
+  }
+
+  void run(int timeoutMs = 1000) {
+    running_ = true;
+    while (running_ && poll(timeoutMs) >= 0) {
+    }
+  }
+  void stop() { running_ = false; }
+
+  /**
+   * @brief send what the windows allow and the acks due, then prepare a
+   * send chain for every link with queued frames and no chain in flight,
+   * they are submitted with the next poll()
+   */
+  void flush() {
+    if (acceptDeferred_ && listenFd_ >= 0) {
+      armAccept_();
+    }
+    /// a link whose request found no sqe is marked again, for the next one
+    flushing_.swap(dirty_);
+    for (Connection *connection : flushing_) {
+      if (connection->open_) {
+        connection->link_.flush(*connection);
+      }
+      connection->dirty_ = false;
+      if (connection->open_ && !connection->receiving_) {
+        armReceive_(*connection);
+      }
+      if (connection->open_ && connection->sending_ == 0) {
+        armSend_(*connection);
+      }
+    }
+    flushing_.clear();
+  }
+
+  size_t connectionCount() const { return active_; }
+  const UringServerStats &stats() const { return stats_; }
+
+private:
+  enum Op { kAccept = 0, kReceive = 1, kSend = 2 };
+  enum { kBufferGroup = 0 };
+
+  bool setupRing_() {
+    int ret = ring_.setup(kQueueDepth);
+    if (ret == 0) {
+      ret = ring_.setupBufferRing(kBufferCount, kBufferGroup);
+    }
+    if (ret < 0) {
+      ring_.close();
+      errno = -ret;
+      return false;
+    }
+    if (buffers_ == nullptr) {
+      buffers_ = static_cast<uint8_t *>(
+          std::malloc(static_cast<size_t>(kBufferCount) * kBufferSize));
+      if (buffers_ == nullptr) {
+        ring_.close();
+        errno = ENOMEM;
+        return false;
+      }
+    }
+    for (unsigned i = 0; i < kBufferCount; ++i) {
+      ring_.provideBuffer(buffers_ + i * kBufferSize, kBufferSize,
+                          static_cast<uint16_t>(i));
+    }
+    ring_.publishBuffers();
+    return true;
+  }
+
+  /**
+   * @brief an sqe, submitting what is prepared if the queue is full
+   *
+   * @return nullptr if the kernel takes none, e.g. -EBUSY while the
+   * completions of the batch in hand are not yet handed back. the request
+   * is then prepared again by the next flush()
+   */
+  io_uring_sqe *sqe_() {
+    io_uring_sqe *sqe = ring_.sqe();
+    if (sqe == nullptr) {
+      ++stats_.submitCalls;
+      ring_.submit();
+      sqe = ring_.sqe();
+    }
+    return sqe;
+  }
+
+  /**
+   * @brief the user data of a request: the connection, or for an accept
+   * the listen socket generation, and the op in the low 2 bits
+   */
+  static uint64_t tag_(Connection *connection, Op op) {
+    return reinterpret_cast<uintptr_t>(connection) | op;
+  }
+
+  void armAccept_() {
+    io_uring_sqe *sqe = sqe_();
+    accepting_ = sqe != nullptr;
+    acceptDeferred_ = sqe == nullptr;
+    if (sqe == nullptr) {
+      return;
+    }
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = listenFd_;
+    sqe->ioprio = IORING_ACCEPT_MULTISHOT;
+    sqe->accept_flags = SOCK_CLOEXEC;
+    sqe->user_data = (listenGeneration_ << 2) | kAccept;
+  }
+
+  void armReceive_(Connection &connection) {
+    io_uring_sqe *sqe = sqe_();
+    if (sqe == nullptr) {
+      connection.markDirty_();
+      return;
+    }
+    sqe->opcode = IORING_OP_RECV;
+    sqe->fd = connection.fd_;
+    sqe->ioprio = IORING_RECV_MULTISHOT;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = kBufferGroup;
+    sqe->user_data = tag_(&connection, kReceive);
+    connection.receiving_ = true;
+  }
+
+  /**
+   * @brief one chain of linked sends, all in one submission: a chain split
+   * by a submit would leave two sends on the socket at once. what does not
+   * fit waits for the next chain
+   */
+  void armSend_(Connection &connection) {
+    iovec iov[Queue::kSlots];
+    size_t n = connection.sendQueue_.gather(iov, Queue::kSlots);
+    if (n > ring_.available()) {
+      ++stats_.submitCalls;
+      ring_.submit();
+      if (n > ring_.available()) {
+        n = ring_.available();
+      }
+    }
+    if (n == 0) {
+      if (!connection.sendQueue_.empty()) {
+        connection.markDirty_();
+      }
+      return;
+    }
+    for (size_t i = 0; i < n; ++i) {
+      io_uring_sqe *sqe = ring_.sqe();
+      sqe->opcode = IORING_OP_SEND;
+      sqe->fd = connection.fd_;
+      sqe->addr = reinterpret_cast<uintptr_t>(iov[i].iov_base);
+      sqe->len = static_cast<uint32_t>(iov[i].iov_len);
+      sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+      if (i + 1 < n) {
+        sqe->flags = IOSQE_IO_LINK;
+      }
+      sqe->user_data = tag_(&connection, kSend);
+    }
+    connection.sending_ = n;
+  }
+
+  void complete_(io_uring_cqe *cqe) {
+    const uint64_t data = cqe->user_data;
+    Connection *connection = reinterpret_cast<Connection *>(
+        static_cast<uintptr_t>(data & ~static_cast<uint64_t>(3)));
+    switch (static_cast<Op>(data & 3)) {
+    case kAccept:
+      if ((data >> 2) == listenGeneration_) {
+        accepted_(cqe);
+      } else if (cqe->res >= 0) {
+        /// accepted on a replaced listen socket
+        ::close(cqe->res);
+      }
+      break;
+    case kReceive:
+      received_(*connection, cqe);
+      break;
+    case kSend:
+      sent_(*connection, cqe);
+      break;
+    }
+  }
+
+  /**
+   * @brief a link accepted, or the multishot accept ended. out of
+   * descriptors the reserve one is freed for the next link, which is
+   * closed at once when it still does not fit, so the backlog drains
+   * instead of the accept failing again at once. without a reserve, or on
+   * another error, accepting pauses until a link closes
+   */
+  void accepted_(io_uring_cqe *cqe) {
+    const int res = cqe->res;
+    if (res >= 0) {
+      if (reserveFd_ < 0 && !restoreReserve_()) {
+        ::close(res);
+        ++stats_.rejected;
+        restoreReserve_();
+      } else {
+        open_(res);
+      }
+    } else if ((res == -EMFILE || res == -ENFILE) && reserveFd_ >= 0) {
+      ::close(reserveFd_);
+      reserveFd_ = -1;
+    } else if (res != -ECONNABORTED && res != -EINTR) {
+      accepting_ = false;
+      return;
+    }
+    if (!(cqe->flags & IORING_CQE_F_MORE) && listenFd_ >= 0) {
+      armAccept_();
+    }
+  }
+
+  bool restoreReserve_() {
+    reserveFd_ = ::open("/dev/null", O_RDONLY | O_CLOEXEC);
+    return reserveFd_ >= 0;
+  }
+
+  void open_(int fd) {
+    int on = 1;
+    ::setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    Connection *connection = allocate_();
+    connection->fd_ = fd;
+    connection->open_ = true;
+    connection->id_ = ++lastId_;
+    Protocol::prepare(connection->codec_);
+    connection->link_.open(windowParameters_, timerParameters_);
+    ++active_;
+    ++stats_.accepted;
+    armReceive_(*connection);
+    if (connectHandler_) {
+      connectHandler_(*connection);
+    }
+  }
+
+  void received_(Connection &connection, io_uring_cqe *cqe) {
+    const int res = cqe->res;
+    if (cqe->flags & IORING_CQE_F_BUFFER) {
+      const uint16_t id =
+          static_cast<uint16_t>(cqe->flags >> IORING_CQE_BUFFER_SHIFT);
+      uint8_t *buffer = buffers_ + static_cast<size_t>(id) * kBufferSize;
+      if (res > 0 && connection.open_) {
+        ++stats_.readCalls;
+        stats_.bytesReceived += static_cast<uint64_t>(res);
+        decode_(connection, buffer, static_cast<size_t>(res));
+      }
+      ring_.provideBuffer(buffer, kBufferSize, id);
+      buffersReturned_ = true;
+    }
+    if (cqe->flags & IORING_CQE_F_MORE) {
+      return;
+    }
+    connection.receiving_ = false;
+    if (res == -ENOBUFS && connection.open_) {
+      ++stats_.bufferShortages;
+      /// the buffers handed back in this batch are seen first
+      ring_.publishBuffers();
+      buffersReturned_ = false;
+      armReceive_(connection);
+    } else if (res > 0 && connection.open_) {
+      /// the kernel ended the multishot receive, keep listening
+      armReceive_(connection);
+    } else {
+      /// end of stream or an error
+      close_(connection);
+      finish_(connection);
+    }
+  }
+
+  void decode_(Connection &connection, const uint8_t *data, size_t size) {
+    auto dispatch = [this, &connection](const View &frame) {
+      ++stats_.apdusReceived;
+      if (!connection.open_) {
+        return;
+      }
+      if (!connection.link_.received(frame)) {
+        close_(connection);
+        return;
+      }
+      if (frameHandler_) {
+        frameHandler_(connection, frame);
+      }
+      /// an ack may be due or the window open again
+      connection.markDirty_();
+    };
+    connection.codec_.decodeStream(data, size, dispatch);
+    if (Protocol::isBroken(connection.codec_)) {
+      close_(connection);
+    }
+  }
+
+  void sent_(Connection &connection, io_uring_cqe *cqe) {
+    --connection.sending_;
+    if (cqe->res >= 0) {
+      ++stats_.writeCalls;
+      stats_.bytesSent += static_cast<uint64_t>(cqe->res);
+      connection.sendQueue_.consume(static_cast<size_t>(cqe->res));
+    } else if (cqe->res != -ECANCELED) {
+      /// -ECANCELED: an earlier send of the chain came up short, the rest
+      /// is sent again by the next chain
+      close_(connection);
+    }
+    if (connection.sending_ != 0) {
+      return;
+    }
+    if (connection.open_ && !connection.sendQueue_.empty()) {
+      connection.markDirty_();
+    }
+    finish_(connection);
+  }
+
+  void expired_(Connection &connection, LinkTimer timer) {
+    ++stats_.timersExpired;
+    if (connection.open_ && !connection.link_.expired(timer, connection)) {
+      close_(connection);
+    }
+  }
+
+  void close_(Connection &connection) {
+    if (!connection.open_) {
+      return;
+    }
+    connection.open_ = false;
+    connection.link_.close();
+    /// completes the receive and the sends in flight, the fd is closed
+    /// by finish_() once they are reaped
+    ::shutdown(connection.fd_, SHUT_RDWR);
+    --active_;
+    ++stats_.closed;
+    if (closeHandler_) {
+      closeHandler_(connection);
+    }
+    finish_(connection);
+  }
+
+  /**
+   * @brief close the socket of a closed link with no request in flight and
+   * recycle the link after the round, a descriptor is free again for a
+   * paused accept
+   */
+  void finish_(Connection &connection) {
+    if (connection.open_ || connection.fd_ < 0 || connection.receiving_ ||
+        connection.sending_ != 0) {
+      return;
+    }
+    ::close(connection.fd_);
+    connection.fd_ = -1;
+    closed_.push_back(&connection);
+    if (!accepting_ && listenFd_ >= 0) {
+      if (reserveFd_ < 0) {
+        restoreReserve_();
+      }
+      armAccept_();
+    }
+  }
+
+  Connection *allocate_() {
+    if (!free_.empty()) {
+      Connection *connection = free_.back();
+      free_.pop_back();
+      return connection;
+    }
+    connections_.emplace_back(new Connection(this, wheel_));
+    Connection *connection = connections_.back().get();
+    connection->link_.onExpiry([this, connection](LinkTimer timer) {
+      expired_(*connection, timer);
+    });
+    return connection;
+  }
+
+  void release_() {
+    for (Connection *connection : closed_) {
+      connection->codec_.reset();
+      connection->sendQueue_.clear();
+      connection->context_ = nullptr;
+      connection->dirty_ = false;
+      free_.push_back(connection);
+    }
+    closed_.clear();
+  }
+
+  Uring ring_;
+  uint8_t *buffers_ = nullptr;
+  /// buffers provided again in the batch, published once after it
+  bool buffersReturned_ = false;
+  int listenFd_ = -1;
+  /// in the user data of the accepts, those of a replaced socket are stale
+  uint64_t listenGeneration_ = 0;
+  bool accepting_ = false;
+  /// the accept found no sqe, flush() prepares it again
+  bool acceptDeferred_ = false;
+  /// held to be freed for a link to reject when descriptors run out
+  int reserveFd_ = -1;
+  bool running_ = false;
+  uint64_t lastId_ = 0;
+  size_t active_ = 0;
+  FrameHandler frameHandler_;
+  ConnectionHandler connectHandler_;
+  ConnectionHandler closeHandler_;
+  UringServerStats stats_;
+  WindowParameters windowParameters_;
+  TimerParameters timerParameters_;
+  /// before connections_, the timers of the connections unlink themselves
+  TimerWheel wheel_;
+
+  std::vector<std::unique_ptr<Connection>> connections_;
+  std::vector<Connection *> free_;
+  std::vector<Connection *> closed_;
+  std::vector<Connection *> dirty_;
+  /// dirty_ while flush() walks it
+  std::vector<Connection *> flushing_;
+};
+
+typedef BasicUringServer<Iec104Protocol> UringServer;
+typedef BasicUringServer<Iec101Protocol> Iec101UringServer;
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
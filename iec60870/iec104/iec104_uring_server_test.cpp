@@ -0,0 +1,335 @@
+#include "iec104_uring_server.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <functional>
+#include <memory>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+namespace {
+int connectTo(uint16_t port) {
+  int fd = ::socket(AF_INET, SOCK_STREAM, 0);
+  sockaddr_in addr;
+  std::memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_port = htons(port);
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  if (::connect(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) != 0) {
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+template <typename S>
+bool pollUntil(S &server, const std::function<bool()> &done) {
+  for (int i = 0; i < 100 && !done(); ++i) {
+    server.poll(10);
+  }
+  return done();
+}
+
+std::vector<uint8_t> receiveAvailable(int fd) {
+  std::vector<uint8_t> bytes;
+  uint8_t buf[4096];
+  for (;;) {
+    ssize_t n = ::recv(fd, buf, sizeof(buf), MSG_DONTWAIT);
+    if (n <= 0) {
+      return bytes;
+    }
+    bytes.insert(bytes.end(), buf, buf + n);
+  }
+}
+
+bool isClosedByPeer(int fd) {
+  pollfd p = {fd, POLLIN, 0};
+  uint8_t ch;
+  return ::poll(&p, 1, 1000) == 1 && ::recv(fd, &ch, 1, 0) == 0;
+}
+
+} // namespace
+
+TEST(UringServer, answers_startdt) {
+  std::unique_ptr<UringServer> server(new UringServer());
+  server->onFrame([](UringServer::Connection &connection,
+                     const ApduView &apdu) {
+    if (apdu.isUFrame() && apdu.uFunction() == UFunction::kStartDtAct) {
+      uint8_t *p = connection.reserve();
+      connection.commit(encodeUFrame(UFunction::kStartDtCon, p, kMaxApduSize));
+    }
+  });
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+
+  int fd = connectTo(server->port());
+  ASSERT_GE(fd, 0);
+  const uint8_t startDt[] = {0x68, 0x04, 0x07, 0x00, 0x00, 0x00};
+  ::send(fd, startDt, 3, 0);
+  server->poll(10);
+  ::send(fd, startDt + 3, 3, 0);
+
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= kApciSize;
+  }));
+  EXPECT_THAT(received, ElementsAre(0x68, 0x04, 0x0b, 0x00, 0x00, 0x00));
+  EXPECT_EQ(server->connectionCount(), 1u);
+  ::close(fd);
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 0;
+  }));
+  EXPECT_EQ(server->stats().closed, 1u);
+}
+
+TEST(UringServer, sends_queued_apdus_as_one_chain) {
+  const size_t kApdus = 20;
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  std::unique_ptr<UringServer> server(new UringServer());
+  server->onConnect([&](UringServer::Connection &connection) {
+    for (uint16_t ns = 0; ns < kApdus; ++ns) {
+      uint8_t *p = connection.reserve();
+      ASSERT_NE(p, nullptr);
+      connection.commit(
+          encodeIFrame(ns, 0, asdu, sizeof(asdu), p, kMaxApduSize));
+    }
+  });
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+
+  int fd = connectTo(server->port());
+  std::vector<uint8_t> received;
+  const size_t expected = kApdus * (kApciSize + sizeof(asdu));
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= expected;
+  }));
+  ASSERT_EQ(received.size(), expected);
+  EXPECT_EQ(server->stats().writeCalls, kApdus);
+  EXPECT_LT(server->stats().submitCalls, kApdus);
+
+  ApduCodec codec;
+  uint16_t ns = 0;
+  codec.decodeStream(received, [&ns](const ApduView &apdu) {
+    EXPECT_EQ(apdu.sendSequence(), ns++);
+  });
+  EXPECT_EQ(ns, kApdus);
+  ::close(fd);
+}
+
+TEST(UringServer, closes_on_malformed_apdu) {
+  std::unique_ptr<UringServer> server(new UringServer());
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  int fd = connectTo(server->port());
+  ASSERT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 1;
+  }));
+  const uint8_t garbage[] = {0x68, 0x04, 0x0f, 0x00, 0x00, 0x00};
+  ::send(fd, garbage, sizeof(garbage), 0);
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 0;
+  }));
+  EXPECT_TRUE(isClosedByPeer(fd));
+  ::close(fd);
+}
+
+TEST(UringServer, tunnels_iec101_frames) {
+  using QIEC60870::p101::LinkLayerFrameView;
+  std::unique_ptr<Iec101UringServer> server(new Iec101UringServer());
+  server->onFrame([](Iec101UringServer::Connection &connection,
+                     const LinkLayerFrameView &frame) {
+    if (frame.functionCode() == 11) {
+      const uint8_t e5 = 0xe5;
+      connection.send(&e5, 1);
+    }
+  });
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+
+  int fd = connectTo(server->port());
+  /// line garbage first, the 101 codec resyncs
+  const uint8_t data[] = {0x00, 0x10, 0x5b, 0x01, 0x5c, 0x16};
+  ::send(fd, data, sizeof(data), 0);
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return !received.empty();
+  }));
+  EXPECT_THAT(received, ElementsAre(0xe5));
+  EXPECT_EQ(server->connectionCount(), 1u);
+  ::close(fd);
+}
+
+TEST(UringServer, t3_sends_testfr_and_t1_closes) {
+  std::unique_ptr<UringServer> server(new UringServer());
+  TimerParameters timers;
+  timers.t1Ms = 100;
+  timers.t3Ms = 50;
+  server->setTimerParameters(timers);
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  int fd = connectTo(server->port());
+  ASSERT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 1;
+  }));
+
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= kApciSize;
+  }));
+  EXPECT_THAT(received, ElementsAre(0x68, 0x04, 0x43, 0x00, 0x00, 0x00));
+  /// no TESTFR con, t1 closes the link
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 0;
+  }));
+  EXPECT_TRUE(isClosedByPeer(fd));
+  EXPECT_EQ(server->stats().timersExpired, 2u);
+  ::close(fd);
+}
+
+TEST(UringServer, window_pipelines_queued_asdus) {
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  std::unique_ptr<UringServer> server(new UringServer());
+  WindowParameters window;
+  window.k = 4;
+  window.w = 2;
+  ASSERT_TRUE(server->setWindowParameters(window));
+  WindowParameters bad;
+  bad.w = 13;
+  EXPECT_FALSE(server->setWindowParameters(bad));
+  UringServer::Connection *link = nullptr;
+  server->onConnect([&](UringServer::Connection &connection) {
+    link = &connection;
+    for (int i = 0; i < 6; ++i) {
+      ASSERT_TRUE(connection.queueAsdu(asdu, sizeof(asdu)));
+    }
+  });
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  int fd = connectTo(server->port());
+
+  const size_t frame = kApciSize + sizeof(asdu);
+  std::vector<uint8_t> received;
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= 4 * frame;
+  }));
+  for (int i = 0; i < 5; ++i) {
+    server->poll(10);
+  }
+  auto more = receiveAvailable(fd);
+  received.insert(received.end(), more.begin(), more.end());
+  /// k stops the window until an ack
+  ASSERT_EQ(received.size(), 4 * frame);
+  ASSERT_NE(link, nullptr);
+  EXPECT_EQ(link->link().window().outstanding(), 4);
+
+  uint8_t ack[kApciSize];
+  encodeSFrame(4, ack, sizeof(ack));
+  ASSERT_EQ(::send(fd, ack, sizeof(ack), 0), 6);
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    auto bytes = receiveAvailable(fd);
+    received.insert(received.end(), bytes.begin(), bytes.end());
+    return received.size() >= 6 * frame;
+  }));
+  ApduCodec codec;
+  uint16_t ns = 0;
+  codec.decodeStream(received, [&ns](const ApduView &apdu) {
+    EXPECT_EQ(apdu.sendSequence(), ns++);
+  });
+  EXPECT_EQ(ns, 6);
+  ::close(fd);
+}
+
+TEST(UringServer, closes_on_sequence_error) {
+  const uint8_t asdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                          0x00, 0x00, 0x00, 0x00, 0x14};
+  std::unique_ptr<UringServer> server(new UringServer());
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  int fd = connectTo(server->port());
+  ASSERT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 1;
+  }));
+  /// N(S) 1 where 0 is expected
+  uint8_t apdu[kMaxApduSize];
+  size_t n = encodeIFrame(1, 0, asdu, sizeof(asdu), apdu, sizeof(apdu));
+  ASSERT_EQ(::send(fd, apdu, n, 0), static_cast<ssize_t>(n));
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 0;
+  }));
+  EXPECT_TRUE(isClosedByPeer(fd));
+  ::close(fd);
+}
+
+TEST(UringServer, closes_links_accepted_on_a_replaced_socket) {
+  std::unique_ptr<UringServer> server(new UringServer());
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  /// the accept is in the kernel, the link is accepted before the socket
+  /// is replaced and completes stale
+  server->poll(0);
+  int client = connectTo(server->port());
+  ASSERT_GE(client, 0);
+  ::usleep(50 * 1000);
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  server->poll(10);
+
+  pollfd p = {client, POLLIN, 0};
+  EXPECT_EQ(::poll(&p, 1, 1000), 1);
+  EXPECT_EQ(server->stats().accepted, 0u);
+  EXPECT_EQ(server->connectionCount(), 0u);
+  ::close(client);
+}
+
+TEST(UringServer, rejects_links_when_out_of_descriptors) {
+  std::unique_ptr<UringServer> server(new UringServer());
+  ASSERT_EQ(server->listen("127.0.0.1", 0), ServerErr::kNoError);
+  int first = connectTo(server->port());
+  ASSERT_GE(first, 0);
+  int second = connectTo(server->port());
+  ASSERT_GE(second, 0);
+  /// no descriptor left above the lowest free one
+  int lowest = ::dup(0);
+  ASSERT_GE(lowest, 0);
+  ::close(lowest);
+  rlimit saved;
+  ASSERT_EQ(::getrlimit(RLIMIT_NOFILE, &saved), 0);
+  rlimit limited = saved;
+  limited.rlim_cur = static_cast<rlim_t>(lowest);
+  ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &limited), 0);
+  for (int i = 0; i < 10; ++i) {
+    server->poll(10);
+  }
+  /// the backlog is drained, the accept waits instead of failing again
+  const int idle = server->poll(10);
+  ASSERT_EQ(::setrlimit(RLIMIT_NOFILE, &saved), 0);
+
+  EXPECT_TRUE(isClosedByPeer(first));
+  EXPECT_TRUE(isClosedByPeer(second));
+  EXPECT_EQ(server->stats().rejected, 2u);
+  EXPECT_EQ(server->stats().accepted, 0u);
+  EXPECT_EQ(idle, 0);
+
+  int third = connectTo(server->port());
+  ASSERT_GE(third, 0);
+  EXPECT_TRUE(pollUntil(*server, [&]() {
+    return server->connectionCount() == 1;
+  }));
+  EXPECT_EQ(server->stats().rejected, 2u);
+  ::close(first);
+  ::close(second);
+  ::close(third);
+}
@@ -0,0 +1,93 @@
+#include "iec104_uring.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+TEST(Uring, nop_completes) {
+  Uring ring;
+  ASSERT_EQ(ring.setup(8), 0);
+  for (uint64_t i = 0; i < 3; ++i) {
+    io_uring_sqe *sqe = ring.sqe();
+    ASSERT_NE(sqe, nullptr);
+    sqe->opcode = IORING_OP_NOP;
+    sqe->user_data = i;
+  }
+  EXPECT_EQ(ring.submit(3, 1000), 3);
+  io_uring_cqe *cqes[8];
+  ASSERT_EQ(ring.peek(cqes, 8), 3u);
+  for (uint64_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(cqes[i]->user_data, i);
+    EXPECT_EQ(cqes[i]->res, 0);
+  }
+  ring.advance(3);
+  EXPECT_EQ(ring.peek(cqes, 8), 0u);
+}
+
+TEST(Uring, sqes_run_out_until_submitted) {
+  Uring ring;
+  ASSERT_EQ(ring.setup(4), 0);
+  for (int i = 0; i < 4; ++i) {
+    io_uring_sqe *sqe = ring.sqe();
+    ASSERT_NE(sqe, nullptr);
+    sqe->opcode = IORING_OP_NOP;
+  }
+  EXPECT_EQ(ring.sqe(), nullptr);
+  EXPECT_EQ(ring.available(), 0u);
+  EXPECT_EQ(ring.submit(), 4);
+  EXPECT_EQ(ring.available(), 4u);
+  EXPECT_NE(ring.sqe(), nullptr);
+  EXPECT_EQ(ring.available(), 3u);
+}
+
+TEST(Uring, wait_times_out) {
+  Uring ring;
+  ASSERT_EQ(ring.setup(4), 0);
+  EXPECT_EQ(ring.submit(1, 10), -ETIME);
+}
+
+TEST(Uring, receives_into_provided_buffers) {
+  Uring ring;
+  ASSERT_EQ(ring.setup(8), 0);
+  std::vector<uint8_t> buffers(4 * 64);
+  ASSERT_EQ(ring.setupBufferRing(4, 7), 0);
+  for (uint16_t i = 0; i < 4; ++i) {
+    ring.provideBuffer(&buffers[i * 64], 64, i);
+  }
+  ring.publishBuffers();
+
+  int fds[2];
+  ASSERT_EQ(::socketpair(AF_UNIX, SOCK_STREAM, 0, fds), 0);
+  io_uring_sqe *sqe = ring.sqe();
+  sqe->opcode = IORING_OP_RECV;
+  sqe->fd = fds[0];
+  sqe->ioprio = IORING_RECV_MULTISHOT;
+  sqe->flags = IOSQE_BUFFER_SELECT;
+  sqe->buf_group = 7;
+  ASSERT_EQ(ring.submit(), 1);
+
+  const uint8_t data[] = {0x68, 0x04, 0x07, 0x00, 0x00, 0x00};
+  for (int round = 0; round < 2; ++round) {
+    ASSERT_EQ(::send(fds[1], data, sizeof(data), 0), 6);
+    ring.submit(1, 1000);
+    io_uring_cqe *cqes[8];
+    ASSERT_EQ(ring.peek(cqes, 8), 1u);
+    EXPECT_EQ(cqes[0]->res, 6);
+    ASSERT_TRUE(cqes[0]->flags & IORING_CQE_F_BUFFER);
+    EXPECT_TRUE(cqes[0]->flags & IORING_CQE_F_MORE);
+    const unsigned id = cqes[0]->flags >> IORING_CQE_BUFFER_SHIFT;
+    EXPECT_EQ(id, static_cast<unsigned>(round));
+    EXPECT_THAT(std::vector<uint8_t>(&buffers[id * 64], &buffers[id * 64] + 6),
+                ElementsAreArray(data));
+    ring.advance(1);
+  }
+  ::close(fds[0]);
+  ::close(fds[1]);
+}
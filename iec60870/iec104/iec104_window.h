@@ -0,0 +1,296 @@
+#ifndef IEC104_WINDOW_H
+#define IEC104_WINDOW_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iec104_apci.h"
+
+namespace QIEC60870 {
+namespace p104 {
+
+/**
+ * @brief the 104 window sizes, the defaults of IEC 60870-5-104 clause 9.6.
+ * on a link with a long round trip a larger k keeps more I frames in
+ * flight, a larger w sends fewer S frames
+ */
+struct WindowParameters {
+  /// I frames sent and not yet acknowledged, at most
+  uint16_t k = 12;
+  /// I frames received before an ack is due, at most, w <= 2k / 3
+  uint16_t w = 8;
+
+  /**
+   * @brief 1 <= k < 32768, half the sequence space would do, and 1 <= w <= k.
+   * k = 0 sends nothing, a k of the whole sequence space can not tell what
+   * an N(R) acks, and with w > k the peer stops before an ack is due
+   *
+   * @return
+   */
+  bool isValid() const { return k >= 1 && k <= 32767 && w >= 1 && w <= k; }
+};
+
+enum class WindowErr {
+  kNoError = 0,
+  /// an I frame with N(S) other than V(R), a frame lost or repeated
+  kSequenceError = 1,
+  /// an N(R) acking an I frame not sent, or one already acked
+  kAckError = 2,
+};
+
+/**
+ * @brief The k/w flow control of one 104 link, sequences modulo 32768:
+ *   V(S)  N(S) of the next I frame sent
+ *   V(R)  N(S) of the next I frame expected
+ *   ack   the oldest I frame sent and not acknowledged
+ * asdus queued are sent as I frames by transmit() while fewer than k are
+ * unacknowledged, all at once into the send queue. received I frames are
+ * acked by the N(R) of every I frame sent, or by an S frame from
+ * acknowledge() when w are unacked or t2 expires, so a steady stream both
+ * ways sends no S frames and one the other way gets one per w.
+ *
+ *   window.queue(asdu, size);        // any number
+ *   window.transmit(connection);     // up to k in flight
+ *   if (window.received(apdu) != WindowErr::kNoError) { close }
+ *   if (window.isAckDue()) { window.acknowledge(connection); }
+ *
+ * the sink of transmit() and acknowledge() is anything with reserve() and
+ * commit(size), e.g. Connection or SendQueue. the window does not know of
+ * STARTDT, queue nothing before data transfer is started
+ */
+class Window {
+public:
+  /**
+   * @brief
+   *
+   * @param parameters the defaults are kept if !parameters.isValid()
+   */
+  explicit Window(const WindowParameters &parameters = WindowParameters()) {
+    setParameters(parameters);
+  }
+
+  /**
+   * @brief for the links reset after the call
+   *
+   * @param parameters
+   * @return false if !parameters.isValid(), the parameters are kept
+   */
+  bool setParameters(const WindowParameters &parameters) {
+    if (!parameters.isValid()) {
+      return false;
+    }
+    parameters_ = parameters;
+    return true;
+  }
+  const WindowParameters &parameters() const { return parameters_; }
+
+  /**
+   * @brief a new link, all sequences 0 and nothing queued
+   */
+  void reset() {
+    sendSequence_ = 0;
+    receiveSequence_ = 0;
+    acknowledged_ = 0;
+    newlyAcknowledged_ = 0;
+    unacknowledgedReceived_ = 0;
+    queue_.clear();
+    queueHead_ = 0;
+    queued_ = 0;
+  }
+
+  /**
+   * @brief queue an asdu to be sent as an I frame, copied
+   *
+   * @param asdu
+   * @param size
+   * @return false if the asdu is empty or longer than kMaxAsduLength
+   */
+  bool queue(const uint8_t *asdu, size_t size) {
+    if (size == 0 || size > kMaxAsduLength) {
+      return false;
+    }
+    if (queueHead_ != 0 && queueHead_ >= queue_.size() / 2) {
+      /// drop what was sent, at most once per half of the buffer
+      queue_.erase(queue_.begin(), queue_.begin() + queueHead_);
+      queueHead_ = 0;
+    }
+    queue_.push_back(static_cast<uint8_t>(size));
+    queue_.insert(queue_.end(), asdu, asdu + size);
+    ++queued_;
+    return true;
+  }
+  /**
+   * @brief the asdus queued and not yet sent
+   *
+   * @return
+   */
+  size_t queued() const { return queued_; }
+
+  /**
+   * @brief send queued asdus as I frames until k are unacknowledged, the
+   * queue is empty or the sink is full. each carries V(R), the ack of all
+   * received I frames
+   *
+   * @param sink
+   * @return the number of I frames sent
+   */
+  template <typename Sink> size_t transmit(Sink &sink) {
+    size_t sent = 0;
+    while (queued_ != 0 && canSend()) {
+      uint8_t *p = sink.reserve();
+      if (p == nullptr) {
+        break;
+      }
+      const size_t size = queue_[queueHead_];
+      const size_t n = encodeIFrame(sendSequence_, receiveSequence_,
+                                    &queue_[queueHead_ + 1], size, p,
+                                    kMaxApduSize);
+      queueHead_ += 1 + size;
+      --queued_;
+      sendSequence_ = (sendSequence_ + 1) % kSequenceModulo;
+      unacknowledgedReceived_ = 0;
+      sink.commit(n);
+      ++sent;
+    }
+    if (queued_ == 0) {
+      queue_.clear();
+      queueHead_ = 0;
+    }
+    return sent;
+  }
+
+  /**
+   * @brief send an S frame with V(R) if any received I frame is not
+   * acknowledged yet, on isAckDue() or on t2 expiry
+   *
+   * @param sink
+   * @return false if nothing was to ack or the sink is full
+   */
+  template <typename Sink> bool acknowledge(Sink &sink) {
+    if (unacknowledgedReceived_ == 0) {
+      return false;
+    }
+    uint8_t *p = sink.reserve();
+    if (p == nullptr) {
+      return false;
+    }
+    unacknowledgedReceived_ = 0;
+    sink.commit(encodeSFrame(receiveSequence_, p, kMaxApduSize));
+    return true;
+  }
+
+  /**
+   * @brief check and count a received I or S frame, U frames are ignored.
+   * on error nothing changes, the link is to be closed
+   *
+   * @param apdu
+   * @return
+   */
+  WindowErr received(const ApduView &apdu) {
+    if (apdu.isUFrame()) {
+      return WindowErr::kNoError;
+    }
+    const uint16_t ack = apdu.receiveSequence();
+    if (distance_(acknowledged_, ack) > outstanding()) {
+      return WindowErr::kAckError;
+    }
+    if (apdu.isIFrame()) {
+      if (apdu.sendSequence() != receiveSequence_) {
+        return WindowErr::kSequenceError;
+      }
+      receiveSequence_ = (receiveSequence_ + 1) % kSequenceModulo;
+      ++unacknowledgedReceived_;
+    }
+    newlyAcknowledged_ = distance_(acknowledged_, ack);
+    acknowledged_ = ack;
+    return WindowErr::kNoError;
+  }
+
+  /**
+   * @brief an I or S frame the application encoded and sent itself, not
+   * through transmit(): an I frame sets V(S) to its N(S) + 1, both ack
+   * what was received. frames of transmit() may be seen here again
+   *
+   * @param apdu
+   */
+  void sent(const ApduView &apdu) {
+    if (apdu.isUFrame()) {
+      return;
+    }
+    if (apdu.isIFrame()) {
+      sendSequence_ = (apdu.sendSequence() + 1) % kSequenceModulo;
+    }
+    unacknowledgedReceived_ = 0;
+  }
+
+  /**
+   * @brief fewer than k I frames are unacknowledged
+   *
+   * @return
+   */
+  bool canSend() const { return outstanding() < parameters_.k; }
+  /**
+   * @brief w received I frames are unacknowledged
+   *
+   * @return
+   */
+  bool isAckDue() const {
+    return unacknowledgedReceived_ >= parameters_.w;
+  }
+
+  uint16_t sendSequence() const { return sendSequence_; }
+  uint16_t receiveSequence() const { return receiveSequence_; }
+  /**
+   * @brief N(S) of the oldest I frame not acknowledged, sendSequence() if
+   * none is
+   *
+   * @return
+   */
+  uint16_t acknowledged() const { return acknowledged_; }
+  /**
+   * @brief I frames sent and not acknowledged
+   *
+   * @return
+   */
+  uint16_t outstanding() const {
+    return distance_(acknowledged_, sendSequence_);
+  }
+  /**
+   * @brief I frames the N(R) of the last I or S frame received acknowledged,
+   * 0 if it acked nothing new
+   *
+   * @return
+   */
+  uint16_t newlyAcknowledged() const { return newlyAcknowledged_; }
+  /**
+   * @brief I frames received and not acknowledged
+   *
+   * @return
+   */
+  uint16_t unacknowledgedReceived() const { return unacknowledgedReceived_; }
+
+private:
+  static uint16_t distance_(uint16_t from, uint16_t to) {
+    return static_cast<uint16_t>((to + kSequenceModulo - from) %
+                                 kSequenceModulo);
+  }
+
+  WindowParameters parameters_;
+  uint16_t sendSequence_ = 0;
+  uint16_t receiveSequence_ = 0;
+  uint16_t acknowledged_ = 0;
+  uint16_t newlyAcknowledged_ = 0;
+  uint16_t unacknowledgedReceived_ = 0;
+  /// the queued asdus, each after one octet of length, sent ones before
+  /// queueHead_
+  std::vector<uint8_t> queue_;
+  size_t queueHead_ = 0;
+  size_t queued_ = 0;
+};
+
+} // namespace p104
+} // namespace QIEC60870
+
+#endif
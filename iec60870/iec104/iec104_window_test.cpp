@@ -0,0 +1,250 @@
+#include "iec104_window.h"
+#include "iec104_send_queue.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::p104;
+
+namespace {
+const uint8_t kAsdu[] = {0x64, 0x01, 0x06, 0x00, 0x01,
+                         0x00, 0x00, 0x00, 0x00, 0x14};
+
+/// a sink keeping every apdu committed
+struct Sink {
+  uint8_t *reserve() { return full ? nullptr : buf; }
+  void commit(size_t size) { apdus.emplace_back(buf, buf + size); }
+  ApduView view(size_t i) const {
+    return ApduView(apdus[i].data(), apdus[i].size());
+  }
+  uint8_t buf[kMaxApduSize];
+  bool full = false;
+  std::vector<std::vector<uint8_t>> apdus;
+};
+
+std::vector<uint8_t> iFrame(uint16_t ns, uint16_t nr) {
+  std::vector<uint8_t> apdu(kMaxApduSize);
+  apdu.resize(encodeIFrame(ns, nr, kAsdu, sizeof(kAsdu), apdu.data(),
+                           apdu.size()));
+  return apdu;
+}
+std::vector<uint8_t> sFrame(uint16_t nr) {
+  std::vector<uint8_t> apdu(kApciSize);
+  encodeSFrame(nr, apdu.data(), apdu.size());
+  return apdu;
+}
+ApduView view(const std::vector<uint8_t> &apdu) {
+  return ApduView(apdu.data(), apdu.size());
+}
+} // namespace
+
+TEST(Window, pipelines_up_to_k) {
+  WindowParameters parameters;
+  parameters.k = 4;
+  parameters.w = 2;
+  Window window(parameters);
+  Sink sink;
+  for (int i = 0; i < 10; ++i) {
+    ASSERT_TRUE(window.queue(kAsdu, sizeof(kAsdu)));
+  }
+  EXPECT_EQ(window.queued(), 10u);
+
+  EXPECT_EQ(window.transmit(sink), 4u);
+  EXPECT_FALSE(window.canSend());
+  EXPECT_EQ(window.outstanding(), 4);
+  EXPECT_EQ(window.queued(), 6u);
+  ASSERT_EQ(sink.apdus.size(), 4u);
+  for (uint16_t i = 0; i < 4; ++i) {
+    ASSERT_TRUE(sink.view(i).isIFrame());
+    EXPECT_EQ(sink.view(i).sendSequence(), i);
+    EXPECT_THAT(std::vector<uint8_t>(sink.view(i).asdu(),
+                                     sink.view(i).asdu() +
+                                         sink.view(i).asduSize()),
+                ElementsAreArray(kAsdu));
+  }
+  EXPECT_EQ(window.transmit(sink), 0u);
+
+  /// an ack of 3 lets 3 more go
+  EXPECT_EQ(window.received(view(sFrame(3))), WindowErr::kNoError);
+  EXPECT_EQ(window.acknowledged(), 3);
+  EXPECT_EQ(window.outstanding(), 1);
+  EXPECT_EQ(window.transmit(sink), 3u);
+  EXPECT_EQ(window.sendSequence(), 7);
+  EXPECT_EQ(window.received(view(sFrame(7))), WindowErr::kNoError);
+  EXPECT_EQ(window.transmit(sink), 3u);
+  EXPECT_EQ(window.queued(), 0u);
+  EXPECT_EQ(sink.view(9).sendSequence(), 9);
+}
+
+TEST(Window, rejects_bad_parameters) {
+  Window window;
+  WindowParameters parameters;
+  parameters.k = 0;
+  EXPECT_FALSE(window.setParameters(parameters));
+  parameters.k = 32768;
+  EXPECT_FALSE(window.setParameters(parameters));
+  parameters.k = 4;
+  parameters.w = 5;
+  EXPECT_FALSE(window.setParameters(parameters));
+  parameters.w = 0;
+  EXPECT_FALSE(window.setParameters(parameters));
+  EXPECT_EQ(window.parameters().k, 12);
+  EXPECT_EQ(window.parameters().w, 8);
+
+  parameters.k = 32767;
+  parameters.w = 32767;
+  EXPECT_TRUE(window.setParameters(parameters));
+  EXPECT_EQ(window.parameters().k, 32767);
+
+  /// the defaults for a constructor given bad ones
+  parameters.k = 0;
+  EXPECT_EQ(Window(parameters).parameters().k, 12);
+}
+
+TEST(Window, stops_when_the_sink_is_full) {
+  Window window;
+  Sink sink;
+  window.queue(kAsdu, sizeof(kAsdu));
+  sink.full = true;
+  EXPECT_EQ(window.transmit(sink), 0u);
+  EXPECT_EQ(window.queued(), 1u);
+  EXPECT_EQ(window.sendSequence(), 0);
+  sink.full = false;
+  EXPECT_EQ(window.transmit(sink), 1u);
+}
+
+TEST(Window, rejects_bad_asdus) {
+  Window window;
+  uint8_t big[kMaxAsduLength + 1] = {};
+  EXPECT_FALSE(window.queue(big, 0));
+  EXPECT_FALSE(window.queue(big, sizeof(big)));
+  EXPECT_TRUE(window.queue(big, kMaxAsduLength));
+}
+
+TEST(Window, acks_every_w_with_one_s_frame) {
+  WindowParameters parameters;
+  parameters.w = 3;
+  Window window(parameters);
+  Sink sink;
+  for (uint16_t ns = 0; ns < 2; ++ns) {
+    EXPECT_EQ(window.received(view(iFrame(ns, 0))), WindowErr::kNoError);
+  }
+  EXPECT_FALSE(window.isAckDue());
+  EXPECT_EQ(window.received(view(iFrame(2, 0))), WindowErr::kNoError);
+  EXPECT_TRUE(window.isAckDue());
+  EXPECT_EQ(window.unacknowledgedReceived(), 3);
+
+  EXPECT_TRUE(window.acknowledge(sink));
+  ASSERT_EQ(sink.apdus.size(), 1u);
+  EXPECT_TRUE(sink.view(0).isSFrame());
+  EXPECT_EQ(sink.view(0).receiveSequence(), 3);
+  EXPECT_FALSE(window.isAckDue());
+  /// nothing to ack, e.g. on t2
+  EXPECT_FALSE(window.acknowledge(sink));
+}
+
+TEST(Window, i_frames_carry_the_ack) {
+  Window window;
+  Sink sink;
+  window.received(view(iFrame(0, 0)));
+  window.received(view(iFrame(1, 0)));
+  window.queue(kAsdu, sizeof(kAsdu));
+  EXPECT_EQ(window.transmit(sink), 1u);
+  EXPECT_EQ(sink.view(0).receiveSequence(), 2);
+  EXPECT_EQ(window.unacknowledgedReceived(), 0);
+  EXPECT_FALSE(window.acknowledge(sink));
+}
+
+TEST(Window, sequence_errors) {
+  Window window;
+  EXPECT_EQ(window.received(view(iFrame(1, 0))), WindowErr::kSequenceError);
+  EXPECT_EQ(window.receiveSequence(), 0);
+  EXPECT_EQ(window.received(view(iFrame(0, 0))), WindowErr::kNoError);
+  /// a repeated frame
+  EXPECT_EQ(window.received(view(iFrame(0, 0))), WindowErr::kSequenceError);
+  /// an ack of a frame not sent
+  EXPECT_EQ(window.received(view(sFrame(1))), WindowErr::kAckError);
+
+  Sink sink;
+  window.queue(kAsdu, sizeof(kAsdu));
+  window.queue(kAsdu, sizeof(kAsdu));
+  window.transmit(sink);
+  EXPECT_EQ(window.received(view(sFrame(2))), WindowErr::kNoError);
+  /// acks never go back
+  EXPECT_EQ(window.received(view(sFrame(1))), WindowErr::kAckError);
+  EXPECT_EQ(window.acknowledged(), 2);
+}
+
+TEST(Window, counts_what_the_last_frame_acked) {
+  Window window;
+  Sink sink;
+  for (int i = 0; i < 3; ++i) {
+    window.queue(kAsdu, sizeof(kAsdu));
+  }
+  window.transmit(sink);
+  EXPECT_EQ(window.received(view(sFrame(2))), WindowErr::kNoError);
+  EXPECT_EQ(window.newlyAcknowledged(), 2);
+  EXPECT_EQ(window.received(view(iFrame(0, 2))), WindowErr::kNoError);
+  EXPECT_EQ(window.newlyAcknowledged(), 0);
+  EXPECT_EQ(window.received(view(sFrame(3))), WindowErr::kNoError);
+  EXPECT_EQ(window.newlyAcknowledged(), 1);
+}
+
+TEST(Window, wraps_modulo_32768) {
+  WindowParameters parameters;
+  parameters.k = 12;
+  Window window(parameters);
+  Sink sink;
+  /// frames the application sent itself set V(S)
+  window.sent(view(iFrame(32760, 0)));
+  window.received(view(sFrame(32761)));
+  EXPECT_EQ(window.outstanding(), 0);
+  for (int i = 0; i < 12; ++i) {
+    window.queue(kAsdu, sizeof(kAsdu));
+  }
+  EXPECT_EQ(window.transmit(sink), 12u);
+  EXPECT_EQ(sink.view(6).sendSequence(), 32767);
+  EXPECT_EQ(sink.view(7).sendSequence(), 0);
+  EXPECT_EQ(window.sendSequence(), 5);
+  EXPECT_EQ(window.outstanding(), 12);
+  EXPECT_EQ(window.received(view(sFrame(2))), WindowErr::kNoError);
+  EXPECT_EQ(window.outstanding(), 3);
+  EXPECT_EQ(window.received(view(sFrame(6))), WindowErr::kAckError);
+  EXPECT_EQ(window.received(view(sFrame(5))), WindowErr::kNoError);
+  EXPECT_EQ(window.outstanding(), 0);
+}
+
+TEST(Window, queue_reuses_its_buffer) {
+  WindowParameters parameters;
+  parameters.k = 1;
+  parameters.w = 1;
+  Window window(parameters);
+  Sink sink;
+  for (uint16_t i = 0; i < 1000; ++i) {
+    window.queue(kAsdu, sizeof(kAsdu));
+    window.queue(kAsdu, sizeof(kAsdu));
+    EXPECT_EQ(window.transmit(sink), 1u);
+    window.received(view(sFrame(window.sendSequence())));
+  }
+  EXPECT_EQ(window.queued(), 1000u);
+  for (uint16_t i = 0; i < 1000; ++i) {
+    EXPECT_EQ(window.transmit(sink), 1u);
+    window.received(view(sFrame(window.sendSequence())));
+  }
+  EXPECT_EQ(window.queued(), 0u);
+  ASSERT_EQ(sink.apdus.size(), 2000u);
+  EXPECT_EQ(sink.view(1999).sendSequence(), 1999);
+}
+
+TEST(Window, into_a_send_queue) {
+  Window window;
+  SendQueue queue;
+  for (int i = 0; i < 20; ++i) {
+    window.queue(kAsdu, sizeof(kAsdu));
+  }
+  EXPECT_EQ(window.transmit(queue), 12u);
+  EXPECT_EQ(queue.size(), 12u);
+}
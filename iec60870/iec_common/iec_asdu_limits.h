@@ -0,0 +1,25 @@
+#ifndef IEC_ASDU_LIMITS_H
+#define IEC_ASDU_LIMITS_H
+
+#include <cstddef>
+
+namespace QIEC60870 {
+
+/**
+ * @brief the longest asdu of a 101 variable frame, whose length octet counts
+ * C, the link address and the asdu and is at most 255
+ *
+ * @param linkAddressSize 0, 1 or 2, a system parameter of the link
+ * @return 254, 253 or 252
+ */
+constexpr size_t maxIec101AsduLength(size_t linkAddressSize) {
+  return 254 - linkAddressSize;
+}
+
+/// the longest asdu of a 104 apdu, whose length octet counts the four
+/// control octets and the asdu and is at most 253
+const size_t kMaxIec104AsduLength = 253 - 4;
+
+} // namespace QIEC60870
+
+#endif
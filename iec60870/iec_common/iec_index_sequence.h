@@ -0,0 +1,21 @@
+#ifndef IEC_INDEX_SEQUENCE_H
+#define IEC_INDEX_SEQUENCE_H
+
+#include <cstddef>
+
+namespace QIEC60870 {
+
+/**
+ * @brief std::index_sequence of c++14, for the tables built at compile
+ * time, e.g. MakeIndexSequence<256>::type for one entry per octet value
+ */
+template <size_t... I> struct IndexSequence {};
+template <size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {};
+template <size_t... I> struct MakeIndexSequence<0, I...> {
+  typedef IndexSequence<I...> type;
+};
+
+} // namespace QIEC60870
+
+#endif
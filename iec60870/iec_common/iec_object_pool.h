@@ -0,0 +1,131 @@
+#ifndef IEC_OBJECT_POOL_H
+#define IEC_OBJECT_POOL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace QIEC60870 {
+
+struct PoolStats {
+  /// acquire() handed out a recycled object
+  uint64_t hits = 0;
+  /// acquire() had to allocate
+  uint64_t misses = 0;
+  /// objects given back and kept for reuse
+  uint64_t recycled = 0;
+  /// objects given back while the pool was full, deleted
+  uint64_t dropped = 0;
+};
+
+/**
+ * @brief recycle hook that leaves the object as it is
+ */
+struct KeepOnRecycle {
+  template <typename T> void operator()(T &) const {}
+};
+
+/**
+ * @brief recycle hook that calls clear(), e.g. for InformationObjectBatch,
+ * which keeps its capacity
+ */
+struct ClearOnRecycle {
+  template <typename T> void operator()(T &object) const { object.clear(); }
+};
+
+/**
+ * @brief Hands out recycled objects, allocating only when none is free.
+ * acquire() returns a unique_ptr that gives the object back when it goes
+ * out of scope, Recycle is applied to it then. up to maxFree objects are
+ * kept, the rest is deleted.
+ * e.g. ObjectPool<p101::LinkLayerFrame> for frames kept past the decode
+ * callback, ObjectPool<asdu::InformationObjectBatch, ClearOnRecycle> for
+ * batches.
+ * there is no locking, use one pool per thread or per channel so that I/O
+ * threads never share an allocator. handles must not outlive the pool
+ */
+template <typename T, typename Recycle = KeepOnRecycle> class ObjectPool {
+public:
+  class Deleter {
+  public:
+    Deleter() = default;
+    explicit Deleter(ObjectPool *pool) : pool_(pool) {}
+    void operator()(T *object) const {
+      if (pool_ != nullptr) {
+        pool_->release_(object);
+      } else {
+        delete object;
+      }
+    }
+
+  private:
+    ObjectPool *pool_ = nullptr;
+  };
+  typedef std::unique_ptr<T, Deleter> Handle;
+
+  explicit ObjectPool(size_t maxFree = 64, Recycle recycle = Recycle())
+      : maxFree_(maxFree), recycle_(recycle) {
+    free_.reserve(maxFree);
+  }
+  ~ObjectPool() {
+    for (T *object : free_) {
+      delete object;
+    }
+  }
+  ObjectPool(const ObjectPool &) = delete;
+  ObjectPool &operator=(const ObjectPool &) = delete;
+
+  /**
+   * @brief a recycled object if there is one, a new T otherwise
+   *
+   * @return
+   */
+  Handle acquire() {
+    if (free_.empty()) {
+      ++stats_.misses;
+      return Handle(new T(), Deleter(this));
+    }
+    ++stats_.hits;
+    T *object = free_.back();
+    free_.pop_back();
+    return Handle(object, Deleter(this));
+  }
+
+  /**
+   * @brief allocate up to n free objects ahead of the first burst
+   *
+   * @param n
+   */
+  void reserve(size_t n) {
+    while (free_.size() < n && free_.size() < maxFree_) {
+      free_.push_back(new T());
+    }
+  }
+
+  size_t freeCount() const { return free_.size(); }
+  size_t maxFree() const { return maxFree_; }
+  const PoolStats &stats() const { return stats_; }
+  void resetStats() { stats_ = PoolStats(); }
+
+private:
+  void release_(T *object) {
+    if (free_.size() < maxFree_) {
+      recycle_(*object);
+      free_.push_back(object);
+      ++stats_.recycled;
+    } else {
+      delete object;
+      ++stats_.dropped;
+    }
+  }
+
+  size_t maxFree_;
+  Recycle recycle_;
+  std::vector<T *> free_;
+  PoolStats stats_;
+};
+
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,79 @@
+#include "iec_object_pool.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870;
+
+namespace {
+struct Counted {
+  Counted() { ++alive; }
+  ~Counted() { --alive; }
+  int value = 0;
+  static int alive;
+};
+int Counted::alive = 0;
+} // namespace
+
+TEST(ObjectPool, recycles) {
+  {
+    ObjectPool<Counted> pool(2);
+    Counted *first;
+    {
+      auto a = pool.acquire();
+      a->value = 7;
+      first = a.get();
+    }
+    auto b = pool.acquire();
+    EXPECT_EQ(b.get(), first);
+    /// KeepOnRecycle
+    EXPECT_EQ(b->value, 7);
+    EXPECT_EQ(pool.stats().misses, 1u);
+    EXPECT_EQ(pool.stats().hits, 1u);
+    EXPECT_EQ(pool.stats().recycled, 1u);
+  }
+  EXPECT_EQ(Counted::alive, 0);
+}
+
+TEST(ObjectPool, bounded_free_list) {
+  ObjectPool<Counted> pool(2);
+  {
+    std::vector<ObjectPool<Counted>::Handle> handles;
+    for (int i = 0; i < 5; ++i) {
+      handles.push_back(pool.acquire());
+    }
+    EXPECT_EQ(Counted::alive, 5);
+  }
+  EXPECT_EQ(pool.freeCount(), 2u);
+  EXPECT_EQ(pool.stats().misses, 5u);
+  EXPECT_EQ(pool.stats().recycled, 2u);
+  EXPECT_EQ(pool.stats().dropped, 3u);
+  EXPECT_EQ(Counted::alive, 2);
+
+  pool.resetStats();
+  pool.reserve(10);
+  EXPECT_EQ(pool.freeCount(), 2u);
+  EXPECT_EQ(pool.stats().misses, 0u);
+}
+
+TEST(ObjectPool, clear_on_recycle_keeps_capacity) {
+  /// as for InformationObjectBatch, whose clear() keeps the columns
+  ObjectPool<std::vector<uint32_t>, ClearOnRecycle> pool(4);
+  pool.reserve(1);
+  size_t capacity;
+  {
+    auto batch = pool.acquire();
+    for (uint32_t i = 0; i < 500; ++i) {
+      batch->push_back(i);
+    }
+    capacity = batch->capacity();
+  }
+  auto batch = pool.acquire();
+  EXPECT_TRUE(batch->empty());
+  EXPECT_EQ(batch->capacity(), capacity);
+  EXPECT_EQ(pool.stats().hits, 2u);
+  EXPECT_EQ(pool.stats().misses, 0u);
+}
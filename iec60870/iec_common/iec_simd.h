@@ -0,0 +1,18 @@
+#ifndef IEC_SIMD_H
+#define IEC_SIMD_H
+
+/// QIEC60870_HAS_SSE2: the target has sse2, always on x86-64
+#if defined(__SSE2__) || defined(_M_X64) ||                                    \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define QIEC60870_HAS_SSE2 1
+#include <emmintrin.h>
+#endif
+
+/// QIEC60870_HAS_AVX2_TARGET: avx2 code can be compiled with
+/// __attribute__((target("avx2"))) and chosen at run time
+#if defined(QIEC60870_HAS_SSE2) && (defined(__GNUC__) || defined(__clang__))
+#define QIEC60870_HAS_AVX2_TARGET 1
+#include <immintrin.h>
+#endif
+
+#endif
@@ -0,0 +1,318 @@
+#ifndef IEC_TIMER_WHEEL_H
+#define IEC_TIMER_WHEEL_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <utility>
+
+#if !defined(__GNUC__) && !defined(__clang__) && defined(_MSC_VER) &&     \
+    defined(_M_X64)
+#include <intrin.h>
+#endif
+
+namespace QIEC60870 {
+
+class TimerWheel;
+
+/**
+ * @brief A timer to be scheduled on a TimerWheel, embedded in its owner,
+ * e.g. one per protocol timer of a link, so arming it never allocates.
+ * the callback is set once, scheduling again re-arms, destroying cancels
+ */
+class Timer {
+public:
+  typedef std::function<void()> Callback;
+
+  explicit Timer(Callback callback = Callback())
+      : callback_(std::move(callback)) {}
+  ~Timer() { cancel(); }
+  Timer(const Timer &) = delete;
+  Timer &operator=(const Timer &) = delete;
+
+  void setCallback(Callback callback) { callback_ = std::move(callback); }
+
+  bool isArmed() const { return prev_ != nullptr; }
+  /**
+   * @brief when it fires, in the milliseconds of the wheel, valid while
+   * armed
+   *
+   * @return
+   */
+  int64_t expiry() const { return static_cast<int64_t>(expiry_); }
+  void cancel();
+
+private:
+  friend class TimerWheel;
+
+  Timer *prev_ = nullptr;
+  Timer *next_ = nullptr;
+  TimerWheel *wheel_ = nullptr;
+  uint64_t expiry_ = 0;
+  Callback callback_;
+};
+
+/**
+ * @brief Hierarchical timing wheel with millisecond ticks: 4 levels of 256
+ * slots, 256 ms, 65.5 s, 4.7 h and 49.7 days wide. schedule(), cancel()
+ * and re-arming are O(1) list operations, whatever the number of timers.
+ * a timer sits in the slot of its level until the level below comes round
+ * to it, then moves down, and fires from level 0 on its exact millisecond.
+ * advance() runs all ticks up to now in one call, skipping the empty ones
+ * with a bitmap of occupied slots, and fires each due slot as a batch.
+ * callbacks may schedule and cancel any timer, the one firing included.
+ * time is whatever monotonic milliseconds the owner passes, not the wall
+ * clock. not thread safe, one wheel per event loop
+ */
+class TimerWheel {
+public:
+  enum { kLevels = 4, kSlots = 256 };
+
+  explicit TimerWheel(int64_t nowMs = 0) : now_(static_cast<uint64_t>(nowMs)) {
+    for (int level = 0; level < kLevels; ++level) {
+      for (int slot = 0; slot < kSlots; ++slot) {
+        Timer &head = slots_[level][slot];
+        head.prev_ = head.next_ = &head;
+      }
+      for (int word = 0; word < kSlots / 64; ++word) {
+        occupied_[level][word] = 0;
+      }
+    }
+  }
+  ~TimerWheel() {
+    for (int level = 0; level < kLevels; ++level) {
+      for (int slot = 0; slot < kSlots; ++slot) {
+        Timer &head = slots_[level][slot];
+        while (head.next_ != &head) {
+          unlink_(*head.next_);
+        }
+        head.prev_ = head.next_ = nullptr;
+      }
+    }
+  }
+  TimerWheel(const TimerWheel &) = delete;
+  TimerWheel &operator=(const TimerWheel &) = delete;
+
+  /**
+   * @brief arm timer to fire delayMs from now(), re-arming it if it is
+   * armed. a delay of 0 or less fires with the next advance() past now()
+   *
+   * @param timer
+   * @param delayMs
+   */
+  void schedule(Timer &timer, int64_t delayMs) {
+    scheduleAt(timer, static_cast<int64_t>(now_) + delayMs);
+  }
+  void scheduleAt(Timer &timer, int64_t whenMs) {
+    timer.cancel();
+    const int64_t earliest = static_cast<int64_t>(now_) + 1;
+    timer.expiry_ = static_cast<uint64_t>(whenMs < earliest ? earliest : whenMs);
+    timer.wheel_ = this;
+    insert_(timer);
+    ++size_;
+  }
+
+  /**
+   * @brief run the ticks up to nowMs and fire the timers due
+   *
+   * @param nowMs a time before now() is ignored
+   * @return the number of timers fired
+   */
+  size_t advance(int64_t nowMs) {
+    const uint64_t target = static_cast<uint64_t>(nowMs);
+    size_t fired = 0;
+    while (now_ < target) {
+      const int64_t wait = timeUntilNext();
+      if (wait < 0 || now_ + static_cast<uint64_t>(wait) > target) {
+        now_ = target;
+        break;
+      }
+      fired += tick_(now_ + static_cast<uint64_t>(wait));
+    }
+    return fired;
+  }
+
+  /**
+   * @brief milliseconds until the wheel next has work, a timer to fire or
+   * to move down a level, e.g. the timeout of epoll_wait(). the wheel may
+   * find nothing due then, it never finds something overdue
+   *
+   * @return -1 if no timer is armed
+   */
+  int64_t timeUntilNext() const {
+    if (size_ == 0) {
+      return -1;
+    }
+    uint64_t best = UINT64_MAX;
+    for (int level = 0; level < kLevels; ++level) {
+      const unsigned shift = 8 * level;
+      const unsigned d = nextOccupied_(level, (now_ >> shift) & (kSlots - 1));
+      if (d != 0) {
+        const uint64_t when = ((now_ >> shift) + d) << shift;
+        best = when < best ? when : best;
+      }
+    }
+    return static_cast<int64_t>(best - now_);
+  }
+
+  int64_t now() const { return static_cast<int64_t>(now_); }
+  /**
+   * @brief the number of armed timers
+   *
+   * @return
+   */
+  size_t size() const { return size_; }
+
+private:
+  friend class Timer;
+
+  static const uint64_t kRange = static_cast<uint64_t>(1) << (8 * kLevels);
+
+  void insert_(Timer &timer) {
+    const uint64_t delta = timer.expiry_ - now_;
+    int level = 0;
+    while (level < kLevels - 1 &&
+           delta >= (static_cast<uint64_t>(1) << (8 * (level + 1)))) {
+      ++level;
+    }
+    /// beyond the top level it waits in the last slot before the current
+    /// one and is placed again when that slot comes round
+    const uint64_t when = delta < kRange ? timer.expiry_ : now_ + kRange - 1;
+    const unsigned slot = (when >> (8 * level)) & (kSlots - 1);
+    Timer &head = slots_[level][slot];
+    timer.prev_ = head.prev_;
+    timer.next_ = &head;
+    head.prev_->next_ = &timer;
+    head.prev_ = &timer;
+    occupied_[level][slot / 64] |= static_cast<uint64_t>(1) << (slot % 64);
+  }
+
+  void unlink_(Timer &timer) {
+    timer.prev_->next_ = timer.next_;
+    timer.next_->prev_ = timer.prev_;
+    timer.prev_ = timer.next_ = nullptr;
+    timer.wheel_ = nullptr;
+    --size_;
+  }
+
+  /**
+   * @brief cancel() leaves the bit of a slot it empties set, the slot is
+   * found empty and the bit cleared when its tick comes
+   */
+  void clearIfEmpty_(int level, unsigned slot) {
+    const Timer &head = slots_[level][slot];
+    if (head.next_ == &head) {
+      occupied_[level][slot / 64] &= ~(static_cast<uint64_t>(1) << (slot % 64));
+    }
+  }
+
+  /**
+   * @brief the distance from slot from to the next occupied slot of level,
+   * going round, from itself only after all others
+   *
+   * @return 1 .. kSlots, 0 if the level is empty
+   */
+  unsigned nextOccupied_(int level, unsigned from) const {
+    for (unsigned d = 1; d <= kSlots;) {
+      const unsigned slot = (from + d) & (kSlots - 1);
+      const uint64_t bits = occupied_[level][slot / 64] >> (slot % 64);
+      if (bits != 0) {
+        const unsigned found = d + countTrailingZeros_(bits);
+        return found <= kSlots ? found : 0;
+      }
+      d += 64 - slot % 64;
+    }
+    return 0;
+  }
+
+  /**
+   * @brief the index of the lowest bit set
+   *
+   * @param bits not 0
+   * @return
+   */
+  static unsigned countTrailingZeros_(uint64_t bits) {
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<unsigned>(__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, bits);
+    return static_cast<unsigned>(index);
+#else
+    unsigned n = 0;
+    for (; (bits & 1) == 0; bits >>= 1) {
+      ++n;
+    }
+    return n;
+#endif
+  }
+
+  /**
+   * @brief move the timers of a slot down, each to where it belongs now
+   */
+  void cascade_(int level, unsigned slot) {
+    Timer &head = slots_[level][slot];
+    Timer *timer = head.next_;
+    head.prev_ = head.next_ = &head;
+    occupied_[level][slot / 64] &= ~(static_cast<uint64_t>(1) << (slot % 64));
+    while (timer != &head) {
+      Timer *next = timer->next_;
+      insert_(*timer);
+      timer = next;
+    }
+  }
+
+  size_t tick_(uint64_t tick) {
+    now_ = tick;
+    int top = 0;
+    while (top < kLevels - 1 && ((tick >> (8 * top)) & (kSlots - 1)) == 0) {
+      ++top;
+    }
+    for (int level = top; level >= 1; --level) {
+      cascade_(level, (tick >> (8 * level)) & (kSlots - 1));
+    }
+
+    /// take the whole slot off the wheel first, so that timers the
+    /// callbacks schedule for this very slot wait for its next round
+    const unsigned slot = tick & (kSlots - 1);
+    Timer &head = slots_[0][slot];
+    if (head.next_ == &head) {
+      clearIfEmpty_(0, slot);
+      return 0;
+    }
+    Timer due;
+    due.next_ = head.next_;
+    due.prev_ = head.prev_;
+    due.next_->prev_ = &due;
+    due.prev_->next_ = &due;
+    head.prev_ = head.next_ = &head;
+    clearIfEmpty_(0, slot);
+
+    size_t fired = 0;
+    while (due.next_ != &due) {
+      Timer &timer = *due.next_;
+      unlink_(timer);
+      ++fired;
+      if (timer.callback_) {
+        timer.callback_();
+      }
+    }
+    due.prev_ = due.next_ = nullptr;
+    return fired;
+  }
+
+  uint64_t now_;
+  size_t size_ = 0;
+  Timer slots_[kLevels][kSlots];
+  uint64_t occupied_[kLevels][kSlots / 64];
+};
+
+inline void Timer::cancel() {
+  if (wheel_ != nullptr) {
+    wheel_->unlink_(*this);
+  }
+}
+
+} // namespace QIEC60870
+
+#endif
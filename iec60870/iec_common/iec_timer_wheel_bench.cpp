@@ -0,0 +1,71 @@
+#include "iec_timer_wheel.h"
+
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <vector>
+
+using namespace QIEC60870;
+
+namespace {
+/// t3 of many idle links re-armed on every received frame
+const int64_t kT3 = 20000;
+} // namespace
+
+static void BM_TimerWheelRearm(benchmark::State &state) {
+  const size_t links = state.range(0);
+  TimerWheel wheel;
+  std::vector<Timer> timers(links);
+  for (size_t i = 0; i < links; ++i) {
+    wheel.schedule(timers[i], kT3);
+  }
+  size_t i = 0;
+  int64_t now = 0;
+  for (auto _ : state) {
+    wheel.schedule(timers[i], kT3);
+    if (++i == links) {
+      i = 0;
+      wheel.advance(++now);
+    }
+  }
+}
+BENCHMARK(BM_TimerWheelRearm)->Arg(1000)->Arg(100000);
+
+static void BM_MultimapRearm(benchmark::State &state) {
+  const size_t links = state.range(0);
+  std::multimap<int64_t, size_t> timers;
+  std::vector<std::multimap<int64_t, size_t>::iterator> handles(links);
+  for (size_t i = 0; i < links; ++i) {
+    handles[i] = timers.insert(std::make_pair(kT3, i));
+  }
+  size_t i = 0;
+  int64_t now = 0;
+  for (auto _ : state) {
+    timers.erase(handles[i]);
+    handles[i] = timers.insert(std::make_pair(now + kT3, i));
+    if (++i == links) {
+      i = 0;
+      ++now;
+    }
+  }
+}
+BENCHMARK(BM_MultimapRearm)->Arg(1000)->Arg(100000);
+
+static void BM_TimerWheelExpire(benchmark::State &state) {
+  const size_t links = state.range(0);
+  TimerWheel wheel;
+  std::vector<Timer> timers(links);
+  size_t fired = 0;
+  for (size_t i = 0; i < links; ++i) {
+    timers[i].setCallback([&fired]() { ++fired; });
+  }
+  for (auto _ : state) {
+    for (size_t i = 0; i < links; ++i) {
+      wheel.schedule(timers[i], 1 + i % kT3);
+    }
+    wheel.advance(wheel.now() + kT3);
+  }
+  benchmark::DoNotOptimize(fired);
+  state.SetItemsProcessed(state.iterations() * links);
+}
+BENCHMARK(BM_TimerWheelExpire)->Arg(1000)->Arg(100000);
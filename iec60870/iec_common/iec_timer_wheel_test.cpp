@@ -0,0 +1,188 @@
+#include "iec_timer_wheel.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870;
+
+TEST(TimerWheel, fires_on_the_exact_millisecond) {
+  TimerWheel wheel(1000);
+  std::vector<int64_t> fired;
+  Timer timer([&]() { fired.push_back(wheel.now()); });
+  wheel.schedule(timer, 15000);
+  EXPECT_TRUE(timer.isArmed());
+  EXPECT_EQ(timer.expiry(), 16000);
+  EXPECT_EQ(wheel.size(), 1u);
+
+  EXPECT_EQ(wheel.advance(15999), 0u);
+  EXPECT_TRUE(fired.empty());
+  EXPECT_EQ(wheel.advance(16000), 1u);
+  EXPECT_THAT(fired, ElementsAre(16000));
+  EXPECT_FALSE(timer.isArmed());
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, late_advance_fires_in_expiry_order) {
+  TimerWheel wheel;
+  std::vector<int> order;
+  Timer t1([&]() { order.push_back(1); });
+  Timer t2([&]() { order.push_back(2); });
+  Timer t3([&]() { order.push_back(3); });
+  wheel.schedule(t3, 20000);
+  wheel.schedule(t1, 15);
+  wheel.schedule(t2, 10000);
+  EXPECT_EQ(wheel.advance(60000), 3u);
+  EXPECT_THAT(order, ElementsAre(1, 2, 3));
+  EXPECT_EQ(wheel.now(), 60000);
+}
+
+TEST(TimerWheel, cancel_and_rearm) {
+  TimerWheel wheel;
+  int fired = 0;
+  Timer timer([&]() { ++fired; });
+  wheel.schedule(timer, 100);
+  timer.cancel();
+  EXPECT_FALSE(timer.isArmed());
+  EXPECT_EQ(wheel.size(), 0u);
+  wheel.advance(200);
+  EXPECT_EQ(fired, 0);
+
+  /// re-arming moves it, as t3 is on every received frame
+  wheel.schedule(timer, 100);
+  wheel.advance(250);
+  wheel.schedule(timer, 100);
+  EXPECT_EQ(wheel.size(), 1u);
+  wheel.advance(349);
+  EXPECT_EQ(fired, 0);
+  wheel.advance(350);
+  EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheel, destroying_cancels) {
+  TimerWheel wheel;
+  {
+    Timer timer;
+    wheel.schedule(timer, 100);
+    EXPECT_EQ(wheel.size(), 1u);
+  }
+  EXPECT_EQ(wheel.size(), 0u);
+  EXPECT_EQ(wheel.advance(1000), 0u);
+}
+
+TEST(TimerWheel, callbacks_reschedule_and_cancel) {
+  TimerWheel wheel;
+  std::vector<int64_t> fired;
+  Timer other;
+  Timer periodic;
+  periodic.setCallback([&]() {
+    fired.push_back(wheel.now());
+    if (fired.size() < 3) {
+      wheel.schedule(periodic, 1000);
+    }
+    other.cancel();
+  });
+  /// due on the same tick, in the order scheduled, so other never fires
+  wheel.schedule(periodic, 1000);
+  wheel.schedule(other, 1000);
+  EXPECT_EQ(wheel.advance(10000), 3u);
+  EXPECT_THAT(fired, ElementsAre(1000, 2000, 3000));
+  EXPECT_EQ(wheel.size(), 0u);
+}
+
+TEST(TimerWheel, past_expiry_fires_on_next_tick) {
+  TimerWheel wheel(500);
+  int fired = 0;
+  Timer timer([&]() { ++fired; });
+  wheel.scheduleAt(timer, 10);
+  EXPECT_EQ(timer.expiry(), 501);
+  EXPECT_EQ(wheel.timeUntilNext(), 1);
+  wheel.advance(500);
+  EXPECT_EQ(fired, 0);
+  wheel.advance(501);
+  EXPECT_EQ(fired, 1);
+}
+
+TEST(TimerWheel, time_until_next) {
+  TimerWheel wheel;
+  EXPECT_EQ(wheel.timeUntilNext(), -1);
+  Timer near;
+  Timer far;
+  wheel.schedule(far, 20000);
+  /// a higher level reports when its slot moves down, never later than due
+  EXPECT_GT(wheel.timeUntilNext(), 0);
+  EXPECT_LE(wheel.timeUntilNext(), 20000);
+  wheel.schedule(near, 100);
+  EXPECT_EQ(wheel.timeUntilNext(), 100);
+
+  wheel.advance(100);
+  int64_t steps = 0;
+  while (far.isArmed()) {
+    const int64_t wait = wheel.timeUntilNext();
+    ASSERT_GT(wait, 0);
+    wheel.advance(wheel.now() + wait);
+    ++steps;
+  }
+  EXPECT_EQ(wheel.now(), 20000);
+  EXPECT_LE(steps, 3);
+}
+
+TEST(TimerWheel, beyond_the_top_level) {
+  const int64_t kFar = (int64_t(1) << 32) + 12345;
+  TimerWheel wheel;
+  int fired = 0;
+  Timer timer([&]() { ++fired; });
+  wheel.schedule(timer, kFar);
+  EXPECT_EQ(timer.expiry(), kFar);
+  while (timer.isArmed()) {
+    wheel.advance(wheel.now() + wheel.timeUntilNext());
+  }
+  EXPECT_EQ(fired, 1);
+  EXPECT_EQ(wheel.now(), kFar);
+}
+
+TEST(TimerWheel, matches_an_ordered_map) {
+  std::mt19937 rng(7);
+  TimerWheel wheel(123456);
+  const size_t kTimers = 2000;
+  std::vector<std::unique_ptr<Timer>> timers;
+  std::multimap<int64_t, size_t> expected;
+  std::vector<std::pair<int64_t, size_t>> fired;
+  for (size_t i = 0; i < kTimers; ++i) {
+    timers.emplace_back(new Timer([&fired, &wheel, i]() {
+      fired.push_back(std::make_pair(wheel.now(), i));
+    }));
+  }
+  /// delays across all levels, some re-armed and some cancelled
+  for (size_t i = 0; i < kTimers; ++i) {
+    const int64_t delay = int64_t(1) << (rng() % 27);
+    wheel.schedule(*timers[i], delay + rng() % delay);
+  }
+  for (size_t i = 0; i < kTimers; i += 7) {
+    wheel.schedule(*timers[i], rng() % 100000);
+  }
+  for (size_t i = 3; i < kTimers; i += 11) {
+    timers[i]->cancel();
+  }
+  for (size_t i = 0; i < kTimers; ++i) {
+    if (timers[i]->isArmed()) {
+      expected.insert(std::make_pair(timers[i]->expiry(), i));
+    }
+  }
+  EXPECT_EQ(wheel.size(), expected.size());
+
+  while (wheel.size() != 0) {
+    wheel.advance(wheel.now() + 1 + rng() % 5000);
+  }
+  ASSERT_EQ(fired.size(), expected.size());
+  size_t n = 0;
+  for (auto it = expected.begin(); it != expected.end(); ++it, ++n) {
+    EXPECT_EQ(fired[n].first, it->first);
+    EXPECT_EQ(timers[fired[n].second]->expiry(), it->first);
+  }
+}
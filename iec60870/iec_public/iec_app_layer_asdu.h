@@ -0,0 +1,311 @@
+#ifndef IEC_APP_LAYER_ASDU_H
+#define IEC_APP_LAYER_ASDU_H
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "iec_app_layer_type_id.h"
+
+namespace QIEC60870 {
+namespace asdu {
+enum class AsduParseErr {
+  kNoError = 0,
+  kTooShort = 1,
+  kBadLength = 2,
+  kUnknownTypeId = 3
+};
+
+/**
+ * @brief cause of transmission, the low 6 bits of the first cot octet
+ */
+enum class Cause {
+  kPeriodic = 1,
+  kBackground = 2,
+  kSpontaneous = 3,
+  kInitialized = 4,
+  kRequest = 5,
+  kActivation = 6,
+  kActivationCon = 7,
+  kDeactivation = 8,
+  kDeactivationCon = 9,
+  kActivationTermination = 10,
+  kReturnInfoRemote = 11,
+  kReturnInfoLocal = 12,
+  kFileTransfer = 13,
+  kInterrogatedByStation = 20,
+  kInterrogatedByGroup1 = 21,
+  kInterrogatedByGroup16 = 36,
+  kRequestedByGeneralCounter = 37,
+  kRequestedByGroup1Counter = 38,
+  kRequestedByGroup4Counter = 41,
+  kUnknownTypeId = 44,
+  kUnknownCause = 45,
+  kUnknownCommonAddress = 46,
+  kUnknownIoa = 47,
+};
+
+/**
+ * @brief the field widths of an asdu are system parameters agreed per link,
+ * cot 1 or 2 octets, common address 1 or 2, information object address
+ * 1, 2 or 3
+ */
+struct AsduParameters {
+  AsduParameters(uint8_t cot = 2, uint8_t commonAddress = 2, uint8_t ioa = 3)
+      : cotSize(cot), commonAddressSize(commonAddress), ioaSize(ioa) {}
+
+  /**
+   * @brief type id, vsq, cot and common address
+   *
+   * @return
+   */
+  size_t headerSize() const { return 2 + cotSize + commonAddressSize; }
+
+  uint8_t cotSize;
+  uint8_t commonAddressSize;
+  uint8_t ioaSize;
+};
+
+/// the fixed widths of IEC 60870-5-104
+const AsduParameters kIec104Parameters(2, 2, 3);
+
+namespace detail {
+/**
+ * @brief little endian unsigned integer of 1 to 4 octets
+ */
+inline uint32_t readLE(const uint8_t *data, size_t size) {
+  uint32_t value = 0;
+  for (size_t i = size; i > 0; --i) {
+    value = (value << 8) | data[i - 1];
+  }
+  return value;
+}
+
+/**
+ * @brief little endian unsigned integer of 1 to 4 octets
+ */
+inline void writeLE(uint8_t *data, uint32_t value, size_t size) {
+  for (size_t i = 0; i < size; ++i, value >>= 8) {
+    data[i] = static_cast<uint8_t>(value);
+  }
+}
+
+/**
+ * @brief value can be written in size octets without losing bits
+ */
+inline bool fitsLE(uint32_t value, size_t size) {
+  return size >= 4 || (value >> (8 * size)) == 0;
+}
+} // namespace detail
+
+/**
+ * @brief one information object, element points into the asdu
+ */
+struct InformationObject {
+  uint32_t address;
+  const uint8_t *element;
+  size_t elementSize;
+};
+
+/**
+ * @brief walks the information objects of an asdu, decoding each address
+ * only when it is dereferenced
+ */
+class InformationObjectIterator {
+public:
+  typedef std::forward_iterator_tag iterator_category;
+  typedef InformationObject value_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef const InformationObject *pointer;
+  typedef InformationObject reference;
+
+  InformationObjectIterator() = default;
+  InformationObjectIterator(const uint8_t *objects, size_t elementSize,
+                            uint8_t ioaSize, bool isSequence, size_t index)
+      : objects_(objects), elementSize_(elementSize), ioaSize_(ioaSize),
+        isSequence_(isSequence), index_(index) {}
+
+  InformationObject operator*() const {
+    InformationObject object;
+    if (isSequence_) {
+      object.address = detail::readLE(objects_, ioaSize_) + index_;
+      object.element = objects_ + ioaSize_ + index_ * elementSize_;
+    } else {
+      const uint8_t *p = objects_ + index_ * (ioaSize_ + elementSize_);
+      object.address = detail::readLE(p, ioaSize_);
+      object.element = p + ioaSize_;
+    }
+    object.elementSize = elementSize_;
+    return object;
+  }
+
+  InformationObjectIterator &operator++() {
+    ++index_;
+    return *this;
+  }
+
+  InformationObjectIterator operator++(int) {
+    InformationObjectIterator it = *this;
+    ++index_;
+    return it;
+  }
+
+  bool operator==(const InformationObjectIterator &other) const {
+    return index_ == other.index_ && objects_ == other.objects_;
+  }
+  bool operator!=(const InformationObjectIterator &other) const {
+    return !(*this == other);
+  }
+
+private:
+  const uint8_t *objects_ = nullptr;
+  size_t elementSize_ = 0;
+  uint8_t ioaSize_ = 0;
+  bool isSequence_ = false;
+  size_t index_ = 0;
+};
+
+/**
+ * @brief Parses an asdu in place, e.g. LinkLayerFrameView::asdu(),
+ * nothing is copied, the view is valid as long as the bytes are.
+ * the header fields are read on demand, information objects are walked
+ * lazily with begin()/end(). the element size is derived from the asdu
+ * length and the number of objects, so any type id can be walked
+ */
+class AsduView {
+public:
+  AsduView() = default;
+  AsduView(const uint8_t *data, size_t size,
+           const AsduParameters &params = AsduParameters())
+      : data_(data), size_(size), params_(params) {}
+
+  /**
+   * @brief kTooShort if the header does not fit,
+   * kBadLength if the objects do not divide evenly into numberOfObjects()
+   * elements
+   *
+   * @return
+   */
+  AsduParseErr error() const {
+    if (size_ < params_.headerSize()) {
+      return AsduParseErr::kTooShort;
+    }
+    size_t n = numberOfObjects();
+    size_t bytes = objectsSize();
+    if (n == 0) {
+      return bytes == 0 ? AsduParseErr::kNoError : AsduParseErr::kBadLength;
+    }
+    if (isSequence()) {
+      if (bytes < params_.ioaSize || (bytes - params_.ioaSize) % n != 0) {
+        return AsduParseErr::kBadLength;
+      }
+    } else if (bytes % n != 0 || bytes / n < params_.ioaSize) {
+      return AsduParseErr::kBadLength;
+    }
+    return AsduParseErr::kNoError;
+  }
+
+  /**
+   * @brief error() with the element size taken from the type id, a single
+   * comparison of the length for fixed size types. types with a variable
+   * size (file transfer, private range) fall back to error()
+   *
+   * @return kUnknownTypeId for reserved type ids
+   */
+  AsduParseErr validate() const {
+    if (size_ < params_.headerSize()) {
+      return AsduParseErr::kTooShort;
+    }
+    const TypeDescriptor &type = typeDescriptor(typeId());
+    if (type.category == TypeCategory::kReserved) {
+      return AsduParseErr::kUnknownTypeId;
+    }
+    if (type.isVariableSize) {
+      return error();
+    }
+    size_t n = numberOfObjects();
+    size_t expected = isSequence()
+                          ? (n == 0 ? 0 : params_.ioaSize + n * type.elementSize)
+                          : n * (params_.ioaSize + type.elementSize);
+    return objectsSize() == expected ? AsduParseErr::kNoError
+                                     : AsduParseErr::kBadLength;
+  }
+
+  uint8_t typeId() const { return data_[0]; }
+  uint8_t vsq() const { return data_[1]; }
+  /**
+   * @brief SQ, the objects share one address, incremented per element
+   *
+   * @return
+   */
+  bool isSequence() const { return (data_[1] & 0x80) != 0; }
+  size_t numberOfObjects() const { return data_[1] & 0x7f; }
+
+  int cause() const { return data_[2] & 0x3f; }
+  bool isNegative() const { return (data_[2] & 0x40) != 0; }
+  bool isTest() const { return (data_[2] & 0x80) != 0; }
+  /**
+   * @brief 0 if the cot is a single octet
+   *
+   * @return
+   */
+  int originatorAddress() const {
+    return params_.cotSize == 2 ? data_[3] : 0;
+  }
+  int commonAddress() const {
+    return static_cast<int>(detail::readLE(data_ + 2 + params_.cotSize,
+                                           params_.commonAddressSize));
+  }
+
+  const AsduParameters &parameters() const { return params_; }
+  const uint8_t *data() const { return data_; }
+  size_t size() const { return size_; }
+
+  /**
+   * @brief the information objects, right after the header
+   *
+   * @return
+   */
+  const uint8_t *objects() const { return data_ + params_.headerSize(); }
+  size_t objectsSize() const { return size_ - params_.headerSize(); }
+
+  /**
+   * @brief size of one information element, without its address,
+   * only meaningful if error() is kNoError
+   *
+   * @return
+   */
+  size_t elementSize() const {
+    size_t n = numberOfObjects();
+    if (n == 0) {
+      return 0;
+    }
+    return isSequence() ? (objectsSize() - params_.ioaSize) / n
+                        : objectsSize() / n - params_.ioaSize;
+  }
+
+  /**
+   * @brief only call if error() is kNoError
+   *
+   * @return
+   */
+  InformationObjectIterator begin() const {
+    return InformationObjectIterator(objects(), elementSize(),
+                                     params_.ioaSize, isSequence(), 0);
+  }
+  InformationObjectIterator end() const {
+    return InformationObjectIterator(objects(), elementSize(),
+                                     params_.ioaSize, isSequence(),
+                                     numberOfObjects());
+  }
+
+private:
+  const uint8_t *data_ = nullptr;
+  size_t size_ = 0;
+  AsduParameters params_;
+};
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
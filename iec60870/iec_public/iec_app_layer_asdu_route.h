@@ -0,0 +1,127 @@
+#ifndef IEC_APP_LAYER_ASDU_ROUTE_H
+#define IEC_APP_LAYER_ASDU_ROUTE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "iec_app_layer_asdu.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/**
+ * @brief the fields a gateway routes on, read from the header only
+ */
+struct AsduRoute {
+  uint8_t typeId;
+  uint8_t cause;
+  bool isNegative;
+  bool isTest;
+  uint8_t originatorAddress;
+  uint16_t commonAddress;
+
+  /**
+   * @brief common address, type id and cause in one integer,
+   * for a hash map or a sorted table
+   *
+   * @return
+   */
+  uint32_t key() const {
+    return (static_cast<uint32_t>(commonAddress) << 16) |
+           (static_cast<uint32_t>(typeId) << 8) | cause;
+  }
+};
+
+/**
+ * @brief header-only decode: checks the length against the type id with
+ * AsduView::validate(), which is arithmetic on the header, and reads the
+ * routing fields. no information object is touched, the payload can be
+ * forwarded as is and decoded later by the consumers that need it
+ *
+ * @param asdu
+ * @param route
+ * @return
+ */
+inline AsduParseErr decodeRoute(const AsduView &asdu, AsduRoute &route) {
+  AsduParseErr err = asdu.validate();
+  if (err != AsduParseErr::kNoError) {
+    return err;
+  }
+  route.typeId = asdu.typeId();
+  route.cause = static_cast<uint8_t>(asdu.cause());
+  route.isNegative = asdu.isNegative();
+  route.isTest = asdu.isTest();
+  route.originatorAddress = static_cast<uint8_t>(asdu.originatorAddress());
+  route.commonAddress = static_cast<uint16_t>(asdu.commonAddress());
+  return AsduParseErr::kNoError;
+}
+
+/**
+ * @brief copy an asdu to other field widths, e.g. from a 101 link with
+ * single octet cot and common address to 104. the elements are copied
+ * untouched, when the ioa width is the same the objects are one memcpy.
+ * call only if asdu.validate() is kNoError
+ *
+ * @param asdu
+ * @param to widths of the copy
+ * @param originatorAddress used if asdu has no originator address
+ * @param out
+ * @param outSize
+ * @return size of the copy, 0 if out is too small or the common address
+ * or an ioa does not fit the widths of to
+ */
+inline size_t translateAsdu(const AsduView &asdu, const AsduParameters &to,
+                            uint8_t originatorAddress, uint8_t *out,
+                            size_t outSize) {
+  const AsduParameters &from = asdu.parameters();
+  const size_t n = asdu.numberOfObjects();
+  /// objects with an address, in a sequence only the first one has one
+  const size_t addressed = asdu.isSequence() ? (n == 0 ? 0 : 1) : n;
+  const size_t size = to.headerSize() + asdu.objectsSize() -
+                      addressed * from.ioaSize + addressed * to.ioaSize;
+  if (size > outSize) {
+    return 0;
+  }
+  const uint32_t commonAddress = static_cast<uint32_t>(asdu.commonAddress());
+  if (!detail::fitsLE(commonAddress, to.commonAddressSize)) {
+    return 0;
+  }
+  const uint8_t *in = asdu.data();
+  out[0] = in[0];
+  out[1] = in[1];
+  out[2] = in[2];
+  if (to.cotSize == 2) {
+    out[3] = from.cotSize == 2 ? in[3] : originatorAddress;
+  }
+  detail::writeLE(out + 2 + to.cotSize, commonAddress, to.commonAddressSize);
+
+  const uint8_t *src = asdu.objects();
+  uint8_t *dst = out + to.headerSize();
+  if (from.ioaSize == to.ioaSize) {
+    std::memcpy(dst, src, asdu.objectsSize());
+    return size;
+  }
+  const size_t elements = asdu.elementSize() * (asdu.isSequence() ? n : 1);
+  for (size_t i = 0; i < addressed; ++i) {
+    const uint32_t ioa = detail::readLE(src, from.ioaSize);
+    /// in a sequence the last object is addressed ioa + n - 1
+    const uint32_t last =
+        asdu.isSequence() ? ioa + static_cast<uint32_t>(n - 1) : ioa;
+    if (!detail::fitsLE(last, to.ioaSize)) {
+      return 0;
+    }
+    detail::writeLE(dst, ioa, to.ioaSize);
+    src += from.ioaSize;
+    dst += to.ioaSize;
+    std::memcpy(dst, src, elements);
+    src += elements;
+    dst += elements;
+  }
+  return size;
+}
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
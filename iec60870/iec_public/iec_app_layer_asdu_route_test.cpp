@@ -0,0 +1,105 @@
+#include "iec_app_layer_asdu_route.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+TEST(AsduRoute, decode_route) {
+  /// M_ME_NB_1 spontaneous, test, originator 9, common address 0x0102
+  std::vector<uint8_t> data = {0x0b, 0x01, 0x83, 0x09, 0x02, 0x01,
+                               0x05, 0x00, 0x00, 0x10, 0x00, 0x00};
+  AsduRoute route;
+  ASSERT_EQ(decodeRoute(AsduView(data.data(), data.size()), route),
+            AsduParseErr::kNoError);
+  EXPECT_EQ(route.typeId, 11);
+  EXPECT_EQ(route.cause, 3);
+  EXPECT_TRUE(route.isTest);
+  EXPECT_FALSE(route.isNegative);
+  EXPECT_EQ(route.originatorAddress, 9);
+  EXPECT_EQ(route.commonAddress, 0x0102);
+  EXPECT_EQ(route.key(), 0x01020b03u);
+
+  /// one octet short of the M_ME_NB_1 element
+  EXPECT_EQ(decodeRoute(AsduView(data.data(), data.size() - 1), route),
+            AsduParseErr::kBadLength);
+}
+
+TEST(AsduRoute, translate_101_to_104) {
+  /// 101 link: 1 octet cot and common address, 2 octet ioa,
+  /// M_SP_NA_1 with 2 objects
+  std::vector<uint8_t> data = {0x01, 0x02, 0x03, 0x07, 0x01,
+                               0x10, 0x01, 0x02, 0x10, 0x00};
+  AsduView asdu(data.data(), data.size(), AsduParameters(1, 1, 2));
+  ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+
+  uint8_t out[256];
+  size_t size = translateAsdu(asdu, kIec104Parameters, 0x21, out, sizeof(out));
+  std::vector<uint8_t> expected = {0x01, 0x02, 0x03, 0x21, 0x07, 0x00, 0x01,
+                                   0x10, 0x00, 0x01, 0x02, 0x10, 0x00, 0x00};
+  EXPECT_EQ(std::vector<uint8_t>(out, out + size), expected);
+  EXPECT_EQ(translateAsdu(asdu, kIec104Parameters, 0x21, out, size - 1), 0u);
+
+  /// and back
+  AsduView translated(out, size, kIec104Parameters);
+  ASSERT_EQ(translated.validate(), AsduParseErr::kNoError);
+  uint8_t back[256];
+  size_t backSize =
+      translateAsdu(translated, AsduParameters(1, 1, 2), 0, back, sizeof(back));
+  EXPECT_EQ(std::vector<uint8_t>(back, back + backSize), data);
+}
+
+TEST(AsduRoute, translate_sequence_copies_elements) {
+  /// M_ME_NA_1, SQ=1, 3 elements from ioa 0x000100, widths 2/2/3 to 1/1/2
+  std::vector<uint8_t> data = {0x09, 0x83, 0x14, 0x00, 0x05, 0x00, 0x00,
+                               0x01, 0x00, 0x11, 0x12, 0x13, 0x21, 0x22,
+                               0x23, 0x31, 0x32, 0x33};
+  AsduView asdu(data.data(), data.size());
+  uint8_t out[256];
+  size_t size = translateAsdu(asdu, AsduParameters(1, 1, 2), 0, out,
+                              sizeof(out));
+  std::vector<uint8_t> expected = {0x09, 0x83, 0x14, 0x05, 0x00, 0x01,
+                                   0x11, 0x12, 0x13, 0x21, 0x22, 0x23,
+                                   0x31, 0x32, 0x33};
+  EXPECT_EQ(std::vector<uint8_t>(out, out + size), expected);
+}
+
+TEST(AsduRoute, translate_refuses_narrowing_common_address) {
+  /// M_SP_NA_1, common address 300, does not fit one octet
+  std::vector<uint8_t> data = {0x01, 0x01, 0x03, 0x00, 0x2c, 0x01,
+                               0x01, 0x00, 0x00, 0x01};
+  AsduView asdu(data.data(), data.size());
+  ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+  uint8_t out[256];
+  EXPECT_EQ(translateAsdu(asdu, AsduParameters(1, 1, 3), 0, out, sizeof(out)),
+            0u);
+  EXPECT_EQ(translateAsdu(asdu, AsduParameters(1, 2, 3), 0, out, sizeof(out)),
+            9u);
+}
+
+TEST(AsduRoute, translate_refuses_narrowing_ioa) {
+  /// M_SP_NA_1 with ioa 1 and ioa 70000, the second does not fit 2 octets
+  std::vector<uint8_t> data = {0x01, 0x02, 0x03, 0x00, 0x01, 0x00, 0x01,
+                               0x00, 0x00, 0x01, 0x70, 0x11, 0x01, 0x00};
+  AsduView asdu(data.data(), data.size());
+  ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+  uint8_t out[256];
+  EXPECT_EQ(translateAsdu(asdu, AsduParameters(2, 2, 2), 0, out, sizeof(out)),
+            0u);
+
+  /// SQ=1 from ioa 0xfffe, 3 elements run past 0xffff
+  std::vector<uint8_t> sequence = {0x01, 0x83, 0x03, 0x00, 0x01, 0x00, 0xfe,
+                                   0xff, 0x00, 0x01, 0x00, 0x01};
+  AsduView sequenceAsdu(sequence.data(), sequence.size());
+  ASSERT_EQ(sequenceAsdu.validate(), AsduParseErr::kNoError);
+  EXPECT_EQ(translateAsdu(sequenceAsdu, AsduParameters(2, 2, 2), 0, out,
+                          sizeof(out)),
+            0u);
+  sequence[2 + 2 + 2 + 1] = 0x00; /// from ioa 0x00fe
+  EXPECT_EQ(translateAsdu(sequenceAsdu, AsduParameters(2, 2, 2), 0, out,
+                          sizeof(out)),
+            sequence.size() - 1);
+}
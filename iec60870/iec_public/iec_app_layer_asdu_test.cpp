@@ -0,0 +1,88 @@
+#include "iec_app_layer_asdu.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+TEST(Asdu, header_fields) {
+  /// C_IC_NA_1 activation, originator 0x05, common address 0x0201, QOI 20
+  std::vector<uint8_t> data = {0x64, 0x01, 0x06, 0x05, 0x01,
+                               0x02, 0x00, 0x00, 0x00, 0x14};
+  AsduView asdu(data.data(), data.size(), kIec104Parameters);
+
+  EXPECT_EQ(asdu.error(), AsduParseErr::kNoError);
+  EXPECT_EQ(asdu.typeId(), 100);
+  EXPECT_EQ(asdu.isSequence(), false);
+  EXPECT_EQ(asdu.numberOfObjects(), 1u);
+  EXPECT_EQ(asdu.cause(), static_cast<int>(Cause::kActivation));
+  EXPECT_EQ(asdu.isNegative(), false);
+  EXPECT_EQ(asdu.isTest(), false);
+  EXPECT_EQ(asdu.originatorAddress(), 0x05);
+  EXPECT_EQ(asdu.commonAddress(), 0x0201);
+  EXPECT_EQ(asdu.elementSize(), 1u);
+
+  std::vector<InformationObject> objects(asdu.begin(), asdu.end());
+  ASSERT_EQ(objects.size(), 1u);
+  EXPECT_EQ(objects[0].address, 0u);
+  EXPECT_EQ(objects[0].element, data.data() + 9);
+}
+
+TEST(Asdu, narrow_fields) {
+  /// M_SP_NA_1, 1 octet cot and common address, 2 octet ioa, P/N and T set
+  std::vector<uint8_t> data = {0x01, 0x02, 0xc3, 0x07, 0x01,
+                               0x10, 0x01, 0x02, 0x10, 0x00};
+  AsduView asdu(data.data(), data.size(), AsduParameters(1, 1, 2));
+
+  EXPECT_EQ(asdu.error(), AsduParseErr::kNoError);
+  EXPECT_EQ(asdu.cause(), static_cast<int>(Cause::kSpontaneous));
+  EXPECT_EQ(asdu.isNegative(), true);
+  EXPECT_EQ(asdu.isTest(), true);
+  EXPECT_EQ(asdu.originatorAddress(), 0);
+  EXPECT_EQ(asdu.commonAddress(), 0x07);
+
+  std::vector<uint32_t> addresses;
+  std::vector<uint8_t> values;
+  for (const auto &object : asdu) {
+    addresses.push_back(object.address);
+    values.push_back(object.element[0]);
+  }
+  EXPECT_THAT(addresses, ElementsAre(0x1001, 0x1002));
+  EXPECT_THAT(values, ElementsAre(0x01, 0x00));
+}
+
+TEST(Asdu, sequence_of_elements) {
+  /// M_ME_NB_1, SQ=1, 3 elements from ioa 0x000100
+  std::vector<uint8_t> data = {0x0b, 0x83, 0x14, 0x00, 0x01, 0x00,
+                               0x00, 0x01, 0x00, 0x10, 0x00, 0x00,
+                               0x20, 0x00, 0x00, 0x30, 0x00, 0x00};
+  AsduView asdu(data.data(), data.size());
+
+  EXPECT_EQ(asdu.error(), AsduParseErr::kNoError);
+  EXPECT_EQ(asdu.isSequence(), true);
+  EXPECT_EQ(asdu.elementSize(), 3u);
+
+  std::vector<uint32_t> addresses;
+  std::vector<uint8_t> values;
+  for (const auto &object : asdu) {
+    addresses.push_back(object.address);
+    values.push_back(object.element[0]);
+  }
+  EXPECT_THAT(addresses, ElementsAre(0x100, 0x101, 0x102));
+  EXPECT_THAT(values, ElementsAre(0x10, 0x20, 0x30));
+}
+
+TEST(Asdu, bad_length) {
+  std::vector<uint8_t> data = {0x01, 0x02, 0x03, 0x00, 0x01, 0x00, 0x01, 0x00,
+                               0x00, 0x01, 0x02, 0x00, 0x00, 0x00, 0xff};
+  EXPECT_EQ(AsduView(data.data(), 5).error(), AsduParseErr::kTooShort);
+  EXPECT_EQ(AsduView(data.data(), data.size()).error(),
+            AsduParseErr::kBadLength);
+  EXPECT_EQ(AsduView(data.data(), data.size() - 1).error(),
+            AsduParseErr::kNoError);
+  EXPECT_EQ(AsduView(data.data(), data.size() - 2).error(),
+            AsduParseErr::kBadLength);
+}
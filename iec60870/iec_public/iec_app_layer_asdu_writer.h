@@ -0,0 +1,262 @@
+#ifndef IEC_APP_LAYER_ASDU_WRITER_H
+#define IEC_APP_LAYER_ASDU_WRITER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+
+#include "iec_app_layer_asdu.h"
+#include "iec_app_layer_information_element.h"
+#include "iec_app_layer_type_id.h"
+#include "iec_asdu_limits.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/// the longest asdu of a 101 variable frame with a single octet link
+/// address, maxIec101AsduLength() gives it for the other widths
+const size_t kMaxAsduSize = maxIec101AsduLength(1);
+/// the longest asdu of a 104 apdu
+const size_t kMaxIec104AsduSize = kMaxIec104AsduLength;
+
+/**
+ * @brief Serialises an asdu into a fixed buffer, data()/size() can be
+ * passed to LinkLayerFrame(c, a, data, size) as is.
+ *
+ *   AsduWriter writer(kIec104Parameters, kMaxIec104AsduSize);
+ *   writer.onFull(send)
+ *       .begin(TypeId::kM_ME_NC_1, Cause::kSpontaneous, 1)
+ *       .add<TypeId::kM_ME_NC_1>(100, value)
+ *       .flush();
+ *
+ * an object that does not fit any more, the 128th object, or in a sequence
+ * an address that does not follow on, hands the asdu so far to the full
+ * handler and starts the next one with the same header. without a handler
+ * such objects are dropped and overflowed() is set. an add<Id>() of another
+ * type than begin() drops the object and sets mismatched(). nothing is
+ * allocated per asdu
+ */
+class AsduWriter {
+public:
+  typedef std::function<void(const uint8_t *asdu, size_t size)> FullHandler;
+
+  /**
+   * @brief
+   *
+   * @param params
+   * @param maxSize the longest asdu the link carries: kMaxIec104AsduSize,
+   * or maxIec101AsduLength(linkAddressSize) for 101, at most
+   * maxIec101AsduLength(0)
+   */
+  explicit AsduWriter(const AsduParameters &params = AsduParameters(),
+                      size_t maxSize = kMaxAsduSize)
+      : params_(params),
+        maxSize_(maxSize < kCapacity ? maxSize
+                                     : static_cast<size_t>(kCapacity)) {}
+
+  /**
+   * @brief called with every asdu the writer splits off, and by flush()
+   *
+   * @param handler
+   * @return
+   */
+  AsduWriter &onFull(FullHandler handler) {
+    handler_ = std::move(handler);
+    return *this;
+  }
+
+  /**
+   * @brief start a new asdu without objects, P/N and T cleared
+   *
+   * @param type
+   * @param cause
+   * @param commonAddress
+   * @return
+   */
+  AsduWriter &begin(TypeId type, Cause cause, uint16_t commonAddress) {
+    buf_[0] = static_cast<uint8_t>(type);
+    buf_[1] = 0;
+    buf_[2] = static_cast<uint8_t>(static_cast<int>(cause) & 0x3f);
+    if (params_.cotSize == 2) {
+      buf_[3] = 0;
+    }
+    detail::writeLE(buf_ + 2 + params_.cotSize, commonAddress,
+                    params_.commonAddressSize);
+    size_ = params_.headerSize();
+    overflowed_ = false;
+    mismatched_ = false;
+    return *this;
+  }
+
+  /**
+   * @brief SQ, only before the first object
+   *
+   * @param sequence
+   * @return
+   */
+  AsduWriter &setSequence(bool sequence) {
+    if (numberOfObjects() == 0) {
+      buf_[1] = sequence ? 0x80 : 0x00;
+    }
+    return *this;
+  }
+  AsduWriter &setNegative(bool negative) {
+    buf_[2] = static_cast<uint8_t>((buf_[2] & ~0x40) | (negative ? 0x40 : 0));
+    return *this;
+  }
+  AsduWriter &setTest(bool test) {
+    buf_[2] = static_cast<uint8_t>((buf_[2] & ~0x80) | (test ? 0x80 : 0));
+    return *this;
+  }
+  /**
+   * @brief ignored if the cot is a single octet
+   *
+   * @param address
+   * @return
+   */
+  AsduWriter &setOriginatorAddress(uint8_t address) {
+    if (params_.cotSize == 2) {
+      buf_[3] = address;
+    }
+    return *this;
+  }
+
+  /**
+   * @brief append an object with an encoded element
+   *
+   * @param ioa
+   * @param element
+   * @param elementSize
+   * @return
+   */
+  AsduWriter &addObject(uint32_t ioa, const uint8_t *element,
+                        size_t elementSize) {
+    uint8_t *p = reserve_(ioa, elementSize);
+    if (p != nullptr) {
+      std::memcpy(p, element, elementSize);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief append an object, encoded in place, Id must be the type of
+   * begin()
+   *
+   * @param ioa
+   * @param value
+   * @return
+   */
+  template <TypeId Id>
+  AsduWriter &add(uint32_t ioa,
+                  const typename InformationElement<Id>::Value &value) {
+    if (buf_[0] != static_cast<uint8_t>(Id)) {
+      mismatched_ = true;
+      return *this;
+    }
+    uint8_t *p = reserve_(ioa, InformationElement<Id>::size());
+    if (p != nullptr) {
+      InformationElement<Id>::encode(value, p);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief hand the asdu to the full handler if it has objects and keep the
+   * header for the next objects
+   *
+   * @return
+   */
+  AsduWriter &flush() {
+    if (numberOfObjects() > 0 && handler_) {
+      handler_(buf_, size_);
+      clearObjects_();
+    }
+    return *this;
+  }
+
+  const uint8_t *data() const { return buf_; }
+  size_t size() const { return size_; }
+  size_t numberOfObjects() const { return buf_[1] & 0x7f; }
+  bool isSequence() const { return (buf_[1] & 0x80) != 0; }
+  /**
+   * @brief an object was dropped since begin(), there was no full handler
+   *
+   * @return
+   */
+  bool overflowed() const { return overflowed_; }
+  /**
+   * @brief an add<Id>() with another type than begin() was dropped since
+   * begin()
+   *
+   * @return
+   */
+  bool mismatched() const { return mismatched_; }
+  AsduView view() const { return AsduView(buf_, size_, params_); }
+
+private:
+  /// an asdu of any link
+  enum { kCapacity = maxIec101AsduLength(0) };
+
+  /**
+   * @brief room for one more object, its address written,
+   * splitting off the asdu so far if needed
+   *
+   * @return where the element goes, nullptr if it is dropped
+   */
+  uint8_t *reserve_(uint32_t ioa, size_t elementSize) {
+    if (!fits_(ioa, elementSize)) {
+      if (!handler_ || numberOfObjects() == 0) {
+        overflowed_ = true;
+        return nullptr;
+      }
+      handler_(buf_, size_);
+      clearObjects_();
+      if (!fits_(ioa, elementSize)) {
+        overflowed_ = true;
+        return nullptr;
+      }
+    }
+    const size_t n = numberOfObjects();
+    if (!isSequence() || n == 0) {
+      detail::writeLE(buf_ + size_, ioa, params_.ioaSize);
+      size_ += params_.ioaSize;
+      sequenceNext_ = ioa;
+    }
+    ++sequenceNext_;
+    uint8_t *p = buf_ + size_;
+    size_ += elementSize;
+    buf_[1] = static_cast<uint8_t>((buf_[1] & 0x80) | (n + 1));
+    return p;
+  }
+
+  bool fits_(uint32_t ioa, size_t elementSize) const {
+    const size_t n = numberOfObjects();
+    if (n == 0x7f) {
+      return false;
+    }
+    if (isSequence() && n > 0) {
+      return ioa == sequenceNext_ && size_ + elementSize <= maxSize_;
+    }
+    return size_ + params_.ioaSize + elementSize <= maxSize_;
+  }
+
+  void clearObjects_() {
+    buf_[1] &= 0x80;
+    size_ = params_.headerSize();
+  }
+
+  AsduParameters params_;
+  size_t maxSize_;
+  FullHandler handler_;
+  uint8_t buf_[kCapacity] = {};
+  size_t size_ = 0;
+  uint32_t sequenceNext_ = 0;
+  bool overflowed_ = false;
+  bool mismatched_ = false;
+};
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,190 @@
+#include "iec_app_layer_asdu_writer.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+namespace {
+typedef InformationElement<TypeId::kM_ME_NC_1> ShortFloatElement;
+
+ShortFloatElement::Value shortFloat(float value) {
+  ShortFloatElement::Value element;
+  element.info.value = value;
+  element.info.quality = 0;
+  return element;
+}
+
+struct Collector {
+  void operator()(const uint8_t *asdu, size_t size) {
+    asdus.push_back(std::vector<uint8_t>(asdu, asdu + size));
+  }
+  std::vector<std::vector<uint8_t>> asdus;
+};
+} // namespace
+
+TEST(AsduWriter, interrogation_command) {
+  InformationElement<TypeId::kC_IC_NA_1>::Value qoi;
+  qoi.info.qualifier = 20;
+  AsduWriter writer(kIec104Parameters);
+  writer.begin(TypeId::kC_IC_NA_1, Cause::kActivation, 0x0201)
+      .setOriginatorAddress(0x05)
+      .add<TypeId::kC_IC_NA_1>(0, qoi);
+
+  std::vector<uint8_t> expected = {0x64, 0x01, 0x06, 0x05, 0x01,
+                                   0x02, 0x00, 0x00, 0x00, 0x14};
+  EXPECT_EQ(std::vector<uint8_t>(writer.data(), writer.data() + writer.size()),
+            expected);
+  EXPECT_EQ(writer.view().validate(), AsduParseErr::kNoError);
+  EXPECT_FALSE(writer.overflowed());
+}
+
+TEST(AsduWriter, flags_and_narrow_fields) {
+  uint8_t siq = 0x01;
+  AsduWriter writer(AsduParameters(1, 1, 2));
+  writer.begin(TypeId::kM_SP_NA_1, Cause::kSpontaneous, 0x07)
+      .setNegative(true)
+      .setTest(true)
+      .setOriginatorAddress(0x33)
+      .addObject(0x1001, &siq, 1);
+
+  std::vector<uint8_t> expected = {0x01, 0x01, 0xc3, 0x07, 0x01, 0x10, 0x01};
+  EXPECT_EQ(std::vector<uint8_t>(writer.data(), writer.data() + writer.size()),
+            expected);
+}
+
+TEST(AsduWriter, round_trip_time_tagged) {
+  InformationElement<TypeId::kM_SP_TB_1>::Value value;
+  value.info.value = true;
+  value.info.quality = 0x80;
+  value.time = fromEpochMilliseconds(1614834367890);
+  AsduWriter writer;
+  writer.begin(TypeId::kM_SP_TB_1, Cause::kSpontaneous, 1)
+      .add<TypeId::kM_SP_TB_1>(0x123456, value);
+
+  AsduView asdu = writer.view();
+  ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+  int count = 0;
+  forEachElement<TypeId::kM_SP_TB_1>(
+      asdu, [&](uint32_t address,
+                const InformationElement<TypeId::kM_SP_TB_1>::Value &v) {
+        EXPECT_EQ(address, 0x123456u);
+        EXPECT_EQ(v.info.value, true);
+        EXPECT_EQ(v.info.quality, 0x80);
+        EXPECT_EQ(toEpochMilliseconds(v.time), 1614834367890);
+        ++count;
+      });
+  EXPECT_EQ(count, 1);
+}
+
+TEST(AsduWriter, splits_oversized_lists) {
+  Collector collector;
+  AsduWriter writer(kIec104Parameters, kMaxIec104AsduSize);
+  writer.onFull(std::ref(collector))
+      .begin(TypeId::kM_ME_NC_1, Cause::kSpontaneous, 1);
+  for (int i = 0; i < 100; ++i) {
+    writer.add<TypeId::kM_ME_NC_1>(1000 + i * 2, shortFloat(i * 0.5f));
+  }
+  writer.flush();
+  EXPECT_EQ(writer.numberOfObjects(), 0u);
+
+  /// (249 - 6) / (3 + 5) objects per asdu
+  ASSERT_EQ(collector.asdus.size(), 4u);
+  std::vector<uint32_t> addresses;
+  std::vector<float> values;
+  for (const auto &data : collector.asdus) {
+    EXPECT_LE(data.size(), kMaxIec104AsduSize);
+    AsduView asdu(data.data(), data.size());
+    ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+    EXPECT_EQ(asdu.cause(), static_cast<int>(Cause::kSpontaneous));
+    forEachElement<TypeId::kM_ME_NC_1>(
+        asdu, [&](uint32_t address, const ShortFloatElement::Value &v) {
+          addresses.push_back(address);
+          values.push_back(v.info.value);
+        });
+  }
+  EXPECT_EQ(collector.asdus[0].size(), 6u + 30 * 8);
+  EXPECT_EQ(collector.asdus[3].size(), 6u + 10 * 8);
+  ASSERT_EQ(addresses.size(), 100u);
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(addresses[i], 1000u + i * 2);
+    EXPECT_EQ(values[i], i * 0.5f);
+  }
+}
+
+TEST(AsduWriter, max_size_of_the_link) {
+  /// M_SP_NA_1 of 3 octets per object after a 4 octet header
+  for (size_t linkAddressSize : {0u, 1u, 2u}) {
+    Collector collector;
+    uint8_t siq = 0x01;
+    const size_t maxSize = QIEC60870::maxIec101AsduLength(linkAddressSize);
+    AsduWriter writer(AsduParameters(1, 1, 2), maxSize);
+    writer.onFull(std::ref(collector))
+        .begin(TypeId::kM_SP_NA_1, Cause::kSpontaneous, 1);
+    for (uint32_t ioa = 0; ioa < 200; ++ioa) {
+      writer.addObject(ioa * 2, &siq, 1);
+    }
+    writer.flush();
+    ASSERT_FALSE(collector.asdus.empty());
+    EXPECT_EQ(collector.asdus[0].size(), 4 + (maxSize - 4) / 3 * 3)
+        << linkAddressSize;
+  }
+  EXPECT_EQ(kMaxAsduSize, QIEC60870::maxIec101AsduLength(1));
+  EXPECT_EQ(kMaxIec104AsduSize, 249u);
+}
+
+TEST(AsduWriter, sequence_splits_on_gap_and_count) {
+  Collector collector;
+  uint8_t siq = 0x01;
+  AsduWriter writer;
+  writer.onFull(std::ref(collector))
+      .begin(TypeId::kM_SP_NA_1, Cause::kInterrogatedByStation, 1)
+      .setSequence(true);
+  for (uint32_t ioa = 1; ioa <= 130; ++ioa) {
+    writer.addObject(ioa, &siq, 1);
+  }
+  writer.addObject(500, &siq, 1).flush();
+
+  ASSERT_EQ(collector.asdus.size(), 3u);
+  AsduView first(collector.asdus[0].data(), collector.asdus[0].size());
+  EXPECT_EQ(first.validate(), AsduParseErr::kNoError);
+  EXPECT_TRUE(first.isSequence());
+  EXPECT_EQ(first.numberOfObjects(), 127u);
+  AsduView second(collector.asdus[1].data(), collector.asdus[1].size());
+  EXPECT_EQ(second.numberOfObjects(), 3u);
+  EXPECT_EQ((*second.begin()).address, 128u);
+  AsduView third(collector.asdus[2].data(), collector.asdus[2].size());
+  EXPECT_EQ(third.numberOfObjects(), 1u);
+  EXPECT_EQ((*third.begin()).address, 500u);
+}
+
+TEST(AsduWriter, overflow_without_handler) {
+  AsduWriter writer(kIec104Parameters, 20);
+  writer.begin(TypeId::kM_ME_NC_1, Cause::kSpontaneous, 1);
+  writer.add<TypeId::kM_ME_NC_1>(1, shortFloat(1))
+      .add<TypeId::kM_ME_NC_1>(2, shortFloat(2));
+  EXPECT_EQ(writer.numberOfObjects(), 1u);
+  EXPECT_TRUE(writer.overflowed());
+  writer.begin(TypeId::kM_ME_NC_1, Cause::kSpontaneous, 1);
+  EXPECT_FALSE(writer.overflowed());
+}
+
+TEST(AsduWriter, drops_element_of_another_type) {
+  AsduWriter writer(kIec104Parameters);
+  InformationElement<TypeId::kM_SP_NA_1>::Value sp;
+  sp.info.value = true;
+  sp.info.quality = 0;
+  writer.begin(TypeId::kM_ME_NC_1, Cause::kSpontaneous, 1)
+      .add<TypeId::kM_ME_NC_1>(1, shortFloat(1))
+      .add<TypeId::kM_SP_NA_1>(2, sp);
+  EXPECT_EQ(writer.numberOfObjects(), 1u);
+  EXPECT_TRUE(writer.mismatched());
+  EXPECT_EQ(writer.view().validate(), AsduParseErr::kNoError);
+  writer.begin(TypeId::kM_SP_NA_1, Cause::kSpontaneous, 1)
+      .add<TypeId::kM_SP_NA_1>(2, sp);
+  EXPECT_FALSE(writer.mismatched());
+  EXPECT_EQ(writer.numberOfObjects(), 1u);
+}
@@ -0,0 +1,800 @@
+#ifndef IEC_APP_LAYER_INFORMATION_ELEMENT_H
+#define IEC_APP_LAYER_INFORMATION_ELEMENT_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "iec_app_layer_asdu.h"
+#include "iec_app_layer_time.h"
+#include "iec_app_layer_type_id.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/**
+ * @brief the information part of the elements, kWireSize is its size in the
+ * asdu, a time tag follows it for time tagged types
+ */
+struct NoInformation {
+  enum { kWireSize = 0 };
+};
+/// SIQ
+struct SinglePoint {
+  enum { kWireSize = 1 };
+  bool value;
+  /// BL/SB/NT/IV, bits 4..7
+  uint8_t quality;
+};
+/// DIQ
+struct DoublePoint {
+  enum { kWireSize = 1 };
+  /// 0 indeterminate, 1 off, 2 on, 3 indeterminate
+  uint8_t value;
+  uint8_t quality;
+};
+/// VTI + QDS
+struct StepPosition {
+  enum { kWireSize = 2 };
+  int8_t value;
+  bool transient;
+  uint8_t quality;
+};
+/// BSI + QDS
+struct Bitstring32 {
+  enum { kWireSize = 5 };
+  uint32_t value;
+  uint8_t quality;
+};
+/// NVA + QDS
+struct NormalizedValue {
+  enum { kWireSize = 3 };
+  int16_t raw;
+  uint8_t quality;
+  /// -1.0 .. 1.0 - 2^-15
+  float value() const { return raw / 32768.0f; }
+};
+/// NVA
+struct NormalizedValueWithoutQuality {
+  enum { kWireSize = 2 };
+  int16_t raw;
+  float value() const { return raw / 32768.0f; }
+};
+/// SVA + QDS
+struct ScaledValue {
+  enum { kWireSize = 3 };
+  int16_t value;
+  uint8_t quality;
+};
+/// IEEE STD 754 + QDS
+struct ShortFloat {
+  enum { kWireSize = 5 };
+  float value;
+  uint8_t quality;
+};
+/// BCR
+struct IntegratedTotal {
+  enum { kWireSize = 5 };
+  int32_t value;
+  uint8_t sequence;
+  bool carry;
+  bool adjusted;
+  bool invalid;
+};
+/// SEP + CP16Time2a elapsed time
+struct ProtectionEvent {
+  enum { kWireSize = 3 };
+  /// 0 indeterminate, 1 off, 2 on, 3 indeterminate
+  uint8_t state;
+  /// EI/BL/SB/NT/IV
+  uint8_t quality;
+  uint16_t elapsedMilliseconds;
+};
+/// SPE + QDP + CP16Time2a relay duration
+struct PackedStartEvents {
+  enum { kWireSize = 4 };
+  uint8_t events;
+  uint8_t quality;
+  uint16_t durationMilliseconds;
+};
+/// OCI + QDP + CP16Time2a relay operating time
+struct PackedOutputCircuit {
+  enum { kWireSize = 4 };
+  uint8_t circuits;
+  uint8_t quality;
+  uint16_t operatingMilliseconds;
+};
+/// SCD + QDS
+struct PackedSinglePoints {
+  enum { kWireSize = 5 };
+  uint16_t status;
+  uint16_t changed;
+  uint8_t quality;
+};
+/// SCO
+struct SingleCommand {
+  enum { kWireSize = 1 };
+  bool value;
+  /// QU
+  uint8_t qualifier;
+  /// S/E
+  bool select;
+};
+/// DCO
+struct DoubleCommand {
+  enum { kWireSize = 1 };
+  uint8_t value;
+  uint8_t qualifier;
+  bool select;
+};
+/// RCO
+struct RegulatingStepCommand {
+  enum { kWireSize = 1 };
+  /// 1 next step lower, 2 next step higher
+  uint8_t value;
+  uint8_t qualifier;
+  bool select;
+};
+/// NVA + QOS
+struct SetpointNormalized {
+  enum { kWireSize = 3 };
+  int16_t raw;
+  /// QL
+  uint8_t qualifier;
+  bool select;
+  float value() const { return raw / 32768.0f; }
+};
+/// SVA + QOS
+struct SetpointScaled {
+  enum { kWireSize = 3 };
+  int16_t value;
+  uint8_t qualifier;
+  bool select;
+};
+/// IEEE STD 754 + QOS
+struct SetpointFloat {
+  enum { kWireSize = 5 };
+  float value;
+  uint8_t qualifier;
+  bool select;
+};
+/// BSI
+struct Bitstring32Command {
+  enum { kWireSize = 4 };
+  uint32_t value;
+};
+/// COI
+struct EndOfInitialization {
+  enum { kWireSize = 1 };
+  uint8_t cause;
+  bool afterParameterChange;
+};
+/// QOI
+struct InterrogationCommand {
+  enum { kWireSize = 1 };
+  uint8_t qualifier;
+};
+/// QCC
+struct CounterInterrogationCommand {
+  enum { kWireSize = 1 };
+  /// RQT
+  uint8_t request;
+  /// FRZ
+  uint8_t freeze;
+};
+/// FBP
+struct TestCommand {
+  enum { kWireSize = 2 };
+  uint16_t pattern;
+};
+/// TSC
+struct TestCommandCounter {
+  enum { kWireSize = 2 };
+  uint16_t counter;
+};
+/// QRP
+struct ResetProcessCommand {
+  enum { kWireSize = 1 };
+  uint8_t qualifier;
+};
+/// CP16Time2a
+struct DelayAcquisitionCommand {
+  enum { kWireSize = 2 };
+  uint16_t delayMilliseconds;
+};
+/// NVA + QPM
+struct ParameterNormalized {
+  enum { kWireSize = 3 };
+  int16_t raw;
+  uint8_t qualifier;
+  float value() const { return raw / 32768.0f; }
+};
+/// SVA + QPM
+struct ParameterScaled {
+  enum { kWireSize = 3 };
+  int16_t value;
+  uint8_t qualifier;
+};
+/// IEEE STD 754 + QPM
+struct ParameterFloat {
+  enum { kWireSize = 5 };
+  float value;
+  uint8_t qualifier;
+};
+/// QPA
+struct ParameterActivation {
+  enum { kWireSize = 1 };
+  uint8_t qualifier;
+};
+
+namespace detail {
+inline int16_t readInt16(const uint8_t *p) {
+  return static_cast<int16_t>(p[0] | (p[1] << 8));
+}
+inline uint16_t readUInt16(const uint8_t *p) {
+  return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+inline float readFloat(const uint8_t *p) {
+  uint32_t bits = readLE(p, 4);
+  float value;
+  std::memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+} // namespace detail
+
+inline void decodeInformation(const uint8_t *, NoInformation &) {}
+inline void decodeInformation(const uint8_t *p, SinglePoint &info) {
+  info.value = (p[0] & 0x01) != 0;
+  info.quality = p[0] & 0xf0;
+}
+inline void decodeInformation(const uint8_t *p, DoublePoint &info) {
+  info.value = p[0] & 0x03;
+  info.quality = p[0] & 0xf0;
+}
+inline void decodeInformation(const uint8_t *p, StepPosition &info) {
+  /// 7 bit two's complement
+  info.value = static_cast<int8_t>(static_cast<uint8_t>(p[0] << 1)) >> 1;
+  info.transient = (p[0] & 0x80) != 0;
+  info.quality = p[1];
+}
+inline void decodeInformation(const uint8_t *p, Bitstring32 &info) {
+  info.value = detail::readLE(p, 4);
+  info.quality = p[4];
+}
+inline void decodeInformation(const uint8_t *p, NormalizedValue &info) {
+  info.raw = detail::readInt16(p);
+  info.quality = p[2];
+}
+inline void decodeInformation(const uint8_t *p,
+                              NormalizedValueWithoutQuality &info) {
+  info.raw = detail::readInt16(p);
+}
+inline void decodeInformation(const uint8_t *p, ScaledValue &info) {
+  info.value = detail::readInt16(p);
+  info.quality = p[2];
+}
+inline void decodeInformation(const uint8_t *p, ShortFloat &info) {
+  info.value = detail::readFloat(p);
+  info.quality = p[4];
+}
+inline void decodeInformation(const uint8_t *p, IntegratedTotal &info) {
+  info.value = static_cast<int32_t>(detail::readLE(p, 4));
+  info.sequence = p[4] & 0x1f;
+  info.carry = (p[4] & 0x20) != 0;
+  info.adjusted = (p[4] & 0x40) != 0;
+  info.invalid = (p[4] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, ProtectionEvent &info) {
+  info.state = p[0] & 0x03;
+  info.quality = p[0] & 0xf8;
+  info.elapsedMilliseconds = detail::readUInt16(p + 1);
+}
+inline void decodeInformation(const uint8_t *p, PackedStartEvents &info) {
+  info.events = p[0];
+  info.quality = p[1];
+  info.durationMilliseconds = detail::readUInt16(p + 2);
+}
+inline void decodeInformation(const uint8_t *p, PackedOutputCircuit &info) {
+  info.circuits = p[0];
+  info.quality = p[1];
+  info.operatingMilliseconds = detail::readUInt16(p + 2);
+}
+inline void decodeInformation(const uint8_t *p, PackedSinglePoints &info) {
+  info.status = detail::readUInt16(p);
+  info.changed = detail::readUInt16(p + 2);
+  info.quality = p[4];
+}
+inline void decodeInformation(const uint8_t *p, SingleCommand &info) {
+  info.value = (p[0] & 0x01) != 0;
+  info.qualifier = (p[0] >> 2) & 0x1f;
+  info.select = (p[0] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, DoubleCommand &info) {
+  info.value = p[0] & 0x03;
+  info.qualifier = (p[0] >> 2) & 0x1f;
+  info.select = (p[0] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, RegulatingStepCommand &info) {
+  info.value = p[0] & 0x03;
+  info.qualifier = (p[0] >> 2) & 0x1f;
+  info.select = (p[0] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, SetpointNormalized &info) {
+  info.raw = detail::readInt16(p);
+  info.qualifier = p[2] & 0x7f;
+  info.select = (p[2] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, SetpointScaled &info) {
+  info.value = detail::readInt16(p);
+  info.qualifier = p[2] & 0x7f;
+  info.select = (p[2] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, SetpointFloat &info) {
+  info.value = detail::readFloat(p);
+  info.qualifier = p[4] & 0x7f;
+  info.select = (p[4] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, Bitstring32Command &info) {
+  info.value = detail::readLE(p, 4);
+}
+inline void decodeInformation(const uint8_t *p, EndOfInitialization &info) {
+  info.cause = p[0] & 0x7f;
+  info.afterParameterChange = (p[0] & 0x80) != 0;
+}
+inline void decodeInformation(const uint8_t *p, InterrogationCommand &info) {
+  info.qualifier = p[0];
+}
+inline void decodeInformation(const uint8_t *p,
+                              CounterInterrogationCommand &info) {
+  info.request = p[0] & 0x3f;
+  info.freeze = p[0] >> 6;
+}
+inline void decodeInformation(const uint8_t *p, TestCommand &info) {
+  info.pattern = detail::readUInt16(p);
+}
+inline void decodeInformation(const uint8_t *p, TestCommandCounter &info) {
+  info.counter = detail::readUInt16(p);
+}
+inline void decodeInformation(const uint8_t *p, ResetProcessCommand &info) {
+  info.qualifier = p[0];
+}
+inline void decodeInformation(const uint8_t *p,
+                              DelayAcquisitionCommand &info) {
+  info.delayMilliseconds = detail::readUInt16(p);
+}
+inline void decodeInformation(const uint8_t *p, ParameterNormalized &info) {
+  info.raw = detail::readInt16(p);
+  info.qualifier = p[2];
+}
+inline void decodeInformation(const uint8_t *p, ParameterScaled &info) {
+  info.value = detail::readInt16(p);
+  info.qualifier = p[2];
+}
+inline void decodeInformation(const uint8_t *p, ParameterFloat &info) {
+  info.value = detail::readFloat(p);
+  info.qualifier = p[4];
+}
+inline void decodeInformation(const uint8_t *p, ParameterActivation &info) {
+  info.qualifier = p[0];
+}
+
+namespace detail {
+inline void writeInt16(uint8_t *p, int value) {
+  p[0] = static_cast<uint8_t>(value);
+  p[1] = static_cast<uint8_t>(value >> 8);
+}
+inline void writeUInt32(uint8_t *p, uint32_t value) {
+  writeLE(p, value, 4);
+}
+inline void writeFloat(uint8_t *p, float value) {
+  uint32_t bits;
+  std::memcpy(&bits, &value, sizeof(bits));
+  writeLE(p, bits, 4);
+}
+inline uint8_t commandQualifier(uint8_t value, uint8_t qualifier,
+                                bool select) {
+  return static_cast<uint8_t>((value & 0x03) | ((qualifier & 0x1f) << 2) |
+                              (select ? 0x80 : 0x00));
+}
+} // namespace detail
+
+inline void encodeInformation(const NoInformation &, uint8_t *) {}
+inline void encodeInformation(const SinglePoint &info, uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.value ? 0x01 : 0x00) |
+                              (info.quality & 0xf0));
+}
+inline void encodeInformation(const DoublePoint &info, uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.value & 0x03) | (info.quality & 0xf0));
+}
+inline void encodeInformation(const StepPosition &info, uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.value & 0x7f) |
+                              (info.transient ? 0x80 : 0x00));
+  p[1] = info.quality;
+}
+inline void encodeInformation(const Bitstring32 &info, uint8_t *p) {
+  detail::writeUInt32(p, info.value);
+  p[4] = info.quality;
+}
+inline void encodeInformation(const NormalizedValue &info, uint8_t *p) {
+  detail::writeInt16(p, info.raw);
+  p[2] = info.quality;
+}
+inline void encodeInformation(const NormalizedValueWithoutQuality &info,
+                              uint8_t *p) {
+  detail::writeInt16(p, info.raw);
+}
+inline void encodeInformation(const ScaledValue &info, uint8_t *p) {
+  detail::writeInt16(p, info.value);
+  p[2] = info.quality;
+}
+inline void encodeInformation(const ShortFloat &info, uint8_t *p) {
+  detail::writeFloat(p, info.value);
+  p[4] = info.quality;
+}
+inline void encodeInformation(const IntegratedTotal &info, uint8_t *p) {
+  detail::writeUInt32(p, static_cast<uint32_t>(info.value));
+  p[4] = static_cast<uint8_t>((info.sequence & 0x1f) |
+                              (info.carry ? 0x20 : 0x00) |
+                              (info.adjusted ? 0x40 : 0x00) |
+                              (info.invalid ? 0x80 : 0x00));
+}
+inline void encodeInformation(const ProtectionEvent &info, uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.state & 0x03) | (info.quality & 0xf8));
+  detail::writeInt16(p + 1, info.elapsedMilliseconds);
+}
+inline void encodeInformation(const PackedStartEvents &info, uint8_t *p) {
+  p[0] = info.events;
+  p[1] = info.quality;
+  detail::writeInt16(p + 2, info.durationMilliseconds);
+}
+inline void encodeInformation(const PackedOutputCircuit &info, uint8_t *p) {
+  p[0] = info.circuits;
+  p[1] = info.quality;
+  detail::writeInt16(p + 2, info.operatingMilliseconds);
+}
+inline void encodeInformation(const PackedSinglePoints &info, uint8_t *p) {
+  detail::writeInt16(p, info.status);
+  detail::writeInt16(p + 2, info.changed);
+  p[4] = info.quality;
+}
+inline void encodeInformation(const SingleCommand &info, uint8_t *p) {
+  p[0] = detail::commandQualifier(info.value ? 1 : 0, info.qualifier,
+                                  info.select);
+}
+inline void encodeInformation(const DoubleCommand &info, uint8_t *p) {
+  p[0] = detail::commandQualifier(info.value, info.qualifier, info.select);
+}
+inline void encodeInformation(const RegulatingStepCommand &info, uint8_t *p) {
+  p[0] = detail::commandQualifier(info.value, info.qualifier, info.select);
+}
+inline void encodeInformation(const SetpointNormalized &info, uint8_t *p) {
+  detail::writeInt16(p, info.raw);
+  p[2] = static_cast<uint8_t>((info.qualifier & 0x7f) |
+                              (info.select ? 0x80 : 0x00));
+}
+inline void encodeInformation(const SetpointScaled &info, uint8_t *p) {
+  detail::writeInt16(p, info.value);
+  p[2] = static_cast<uint8_t>((info.qualifier & 0x7f) |
+                              (info.select ? 0x80 : 0x00));
+}
+inline void encodeInformation(const SetpointFloat &info, uint8_t *p) {
+  detail::writeFloat(p, info.value);
+  p[4] = static_cast<uint8_t>((info.qualifier & 0x7f) |
+                              (info.select ? 0x80 : 0x00));
+}
+inline void encodeInformation(const Bitstring32Command &info, uint8_t *p) {
+  detail::writeUInt32(p, info.value);
+}
+inline void encodeInformation(const EndOfInitialization &info, uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.cause & 0x7f) |
+                              (info.afterParameterChange ? 0x80 : 0x00));
+}
+inline void encodeInformation(const InterrogationCommand &info, uint8_t *p) {
+  p[0] = info.qualifier;
+}
+inline void encodeInformation(const CounterInterrogationCommand &info,
+                              uint8_t *p) {
+  p[0] = static_cast<uint8_t>((info.request & 0x3f) | (info.freeze << 6));
+}
+inline void encodeInformation(const TestCommand &info, uint8_t *p) {
+  detail::writeInt16(p, info.pattern);
+}
+inline void encodeInformation(const TestCommandCounter &info, uint8_t *p) {
+  detail::writeInt16(p, info.counter);
+}
+inline void encodeInformation(const ResetProcessCommand &info, uint8_t *p) {
+  p[0] = info.qualifier;
+}
+inline void encodeInformation(const DelayAcquisitionCommand &info,
+                              uint8_t *p) {
+  detail::writeInt16(p, info.delayMilliseconds);
+}
+inline void encodeInformation(const ParameterNormalized &info, uint8_t *p) {
+  detail::writeInt16(p, info.raw);
+  p[2] = info.qualifier;
+}
+inline void encodeInformation(const ParameterScaled &info, uint8_t *p) {
+  detail::writeInt16(p, info.value);
+  p[2] = info.qualifier;
+}
+inline void encodeInformation(const ParameterFloat &info, uint8_t *p) {
+  detail::writeFloat(p, info.value);
+  p[4] = info.qualifier;
+}
+inline void encodeInformation(const ParameterActivation &info, uint8_t *p) {
+  p[0] = info.qualifier;
+}
+
+struct NoTime {};
+
+/**
+ * @brief a decoded information element, time is only there for time
+ * tagged types
+ */
+template <typename Info, typename Time> struct Element {
+  Info info;
+  Time time;
+};
+template <typename Info> struct Element<Info, NoTime> { Info info; };
+
+namespace detail {
+template <typename Time> struct TimeWireSize;
+template <> struct TimeWireSize<NoTime> {
+  enum { value = 0 };
+};
+template <> struct TimeWireSize<Cp24Time2a> {
+  enum { value = 3 };
+};
+template <> struct TimeWireSize<Cp56Time2a> {
+  enum { value = 7 };
+};
+
+template <typename Info>
+inline void decodeTime(const uint8_t *, Element<Info, NoTime> &) {}
+template <typename Info>
+inline void decodeTime(const uint8_t *p, Element<Info, Cp24Time2a> &element) {
+  element.time = decodeCp24Time2a(p);
+}
+template <typename Info>
+inline void decodeTime(const uint8_t *p, Element<Info, Cp56Time2a> &element) {
+  element.time = decodeCp56Time2a(p);
+}
+template <typename Info>
+inline void encodeTime(const Element<Info, NoTime> &, uint8_t *) {}
+template <typename Info>
+inline void encodeTime(const Element<Info, Cp24Time2a> &element, uint8_t *p) {
+  encodeCp24Time2a(element.time, p);
+}
+template <typename Info>
+inline void encodeTime(const Element<Info, Cp56Time2a> &element, uint8_t *p) {
+  encodeCp56Time2a(element.time, p);
+}
+} // namespace detail
+
+/**
+ * @brief the codec of one type id, the element size comes from the
+ * descriptor table and is checked against the layout at compile time
+ */
+template <TypeId Id, typename InfoT, typename TimeT = NoTime>
+struct ElementLayout {
+  typedef InfoT Info;
+  typedef TimeT Time;
+  typedef Element<InfoT, TimeT> Value;
+
+  static_assert(InfoT::kWireSize + detail::TimeWireSize<TimeT>::value ==
+                    typeDescriptor(Id).elementSize,
+                "element layout does not match the type descriptor");
+
+  static constexpr TypeId typeId() { return Id; }
+  static constexpr size_t size() { return typeDescriptor(Id).elementSize; }
+
+  static Value decode(const uint8_t *element) {
+    Value value;
+    decodeInformation(element, value.info);
+    detail::decodeTime(element + InfoT::kWireSize, value);
+    return value;
+  }
+
+  /**
+   * @brief write size() octets
+   *
+   * @param value
+   * @param element
+   */
+  static void encode(const Value &value, uint8_t *element) {
+    encodeInformation(value.info, element);
+    detail::encodeTime(value, element + InfoT::kWireSize);
+  }
+};
+
+/**
+ * @brief specialised for every type id that has a codec,
+ * InformationElement<Id>::decode() turns element bytes into a Value and
+ * encode() back
+ */
+template <TypeId Id> struct InformationElement;
+
+#define QIEC60870_INFORMATION_ELEMENT(ID, ...)                                 \
+  template <>                                                                  \
+  struct InformationElement<TypeId::ID>                                        \
+      : ElementLayout<TypeId::ID, __VA_ARGS__> {}
+
+QIEC60870_INFORMATION_ELEMENT(kM_SP_NA_1, SinglePoint);
+QIEC60870_INFORMATION_ELEMENT(kM_SP_TA_1, SinglePoint, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_DP_NA_1, DoublePoint);
+QIEC60870_INFORMATION_ELEMENT(kM_DP_TA_1, DoublePoint, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ST_NA_1, StepPosition);
+QIEC60870_INFORMATION_ELEMENT(kM_ST_TA_1, StepPosition, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_BO_NA_1, Bitstring32);
+QIEC60870_INFORMATION_ELEMENT(kM_BO_TA_1, Bitstring32, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_NA_1, NormalizedValue);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TA_1, NormalizedValue, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_NB_1, ScaledValue);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TB_1, ScaledValue, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_NC_1, ShortFloat);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TC_1, ShortFloat, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_IT_NA_1, IntegratedTotal);
+QIEC60870_INFORMATION_ELEMENT(kM_IT_TA_1, IntegratedTotal, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TA_1, ProtectionEvent, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TB_1, PackedStartEvents, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TC_1, PackedOutputCircuit, Cp24Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_PS_NA_1, PackedSinglePoints);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_ND_1, NormalizedValueWithoutQuality);
+QIEC60870_INFORMATION_ELEMENT(kM_SP_TB_1, SinglePoint, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_DP_TB_1, DoublePoint, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ST_TB_1, StepPosition, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_BO_TB_1, Bitstring32, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TD_1, NormalizedValue, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TE_1, ScaledValue, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_ME_TF_1, ShortFloat, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_IT_TB_1, IntegratedTotal, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TD_1, ProtectionEvent, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TE_1, PackedStartEvents, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EP_TF_1, PackedOutputCircuit, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_SC_NA_1, SingleCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_DC_NA_1, DoubleCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_RC_NA_1, RegulatingStepCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_NA_1, SetpointNormalized);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_NB_1, SetpointScaled);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_NC_1, SetpointFloat);
+QIEC60870_INFORMATION_ELEMENT(kC_BO_NA_1, Bitstring32Command);
+QIEC60870_INFORMATION_ELEMENT(kC_SC_TA_1, SingleCommand, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_DC_TA_1, DoubleCommand, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_RC_TA_1, RegulatingStepCommand, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_TA_1, SetpointNormalized, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_TB_1, SetpointScaled, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_SE_TC_1, SetpointFloat, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_BO_TA_1, Bitstring32Command, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kM_EI_NA_1, EndOfInitialization);
+QIEC60870_INFORMATION_ELEMENT(kC_IC_NA_1, InterrogationCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_CI_NA_1, CounterInterrogationCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_RD_NA_1, NoInformation);
+QIEC60870_INFORMATION_ELEMENT(kC_CS_NA_1, NoInformation, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kC_TS_NA_1, TestCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_RP_NA_1, ResetProcessCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_CD_NA_1, DelayAcquisitionCommand);
+QIEC60870_INFORMATION_ELEMENT(kC_TS_TA_1, TestCommandCounter, Cp56Time2a);
+QIEC60870_INFORMATION_ELEMENT(kP_ME_NA_1, ParameterNormalized);
+QIEC60870_INFORMATION_ELEMENT(kP_ME_NB_1, ParameterScaled);
+QIEC60870_INFORMATION_ELEMENT(kP_ME_NC_1, ParameterFloat);
+QIEC60870_INFORMATION_ELEMENT(kP_AC_NA_1, ParameterActivation);
+
+#undef QIEC60870_INFORMATION_ELEMENT
+
+/**
+ * @brief decode every information object of an asdu of type Id,
+ * the element size is a compile time constant, so the loop is specialised
+ * per type. call only if asdu.validate() is kNoError
+ *
+ * @param asdu
+ * @param f callable as f(uint32_t address, const InformationElement<Id>::Value &)
+ */
+template <TypeId Id, typename F>
+void forEachElement(const AsduView &asdu, F &&f) {
+  typedef InformationElement<Id> Layout;
+  const uint8_t *p = asdu.objects();
+  const size_t ioaSize = asdu.parameters().ioaSize;
+  const size_t n = asdu.numberOfObjects();
+  if (asdu.isSequence()) {
+    if (n == 0) {
+      return;
+    }
+    uint32_t address = detail::readLE(p, ioaSize);
+    p += ioaSize;
+    for (size_t i = 0; i < n; ++i, p += Layout::size()) {
+      f(address + static_cast<uint32_t>(i), Layout::decode(p));
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i, p += ioaSize + Layout::size()) {
+      f(detail::readLE(p, ioaSize), Layout::decode(p + ioaSize));
+    }
+  }
+}
+
+/**
+ * @brief pick the forEachElement() instantiation for the type id of asdu,
+ * visitor needs a template call operator accepting every Value type
+ *
+ * @param asdu
+ * @param visitor
+ * @return false if asdu.validate() fails or the type id has no decoder
+ */
+template <typename Visitor>
+bool visitElements(const AsduView &asdu, Visitor &&visitor) {
+  if (asdu.validate() != AsduParseErr::kNoError) {
+    return false;
+  }
+  switch (static_cast<TypeId>(asdu.typeId())) {
+#define QIEC60870_VISIT(ID)                                                    \
+  case TypeId::ID:                                                             \
+    forEachElement<TypeId::ID>(asdu, visitor);                                 \
+    return true
+    QIEC60870_VISIT(kM_SP_NA_1);
+    QIEC60870_VISIT(kM_SP_TA_1);
+    QIEC60870_VISIT(kM_DP_NA_1);
+    QIEC60870_VISIT(kM_DP_TA_1);
+    QIEC60870_VISIT(kM_ST_NA_1);
+    QIEC60870_VISIT(kM_ST_TA_1);
+    QIEC60870_VISIT(kM_BO_NA_1);
+    QIEC60870_VISIT(kM_BO_TA_1);
+    QIEC60870_VISIT(kM_ME_NA_1);
+    QIEC60870_VISIT(kM_ME_TA_1);
+    QIEC60870_VISIT(kM_ME_NB_1);
+    QIEC60870_VISIT(kM_ME_TB_1);
+    QIEC60870_VISIT(kM_ME_NC_1);
+    QIEC60870_VISIT(kM_ME_TC_1);
+    QIEC60870_VISIT(kM_IT_NA_1);
+    QIEC60870_VISIT(kM_IT_TA_1);
+    QIEC60870_VISIT(kM_EP_TA_1);
+    QIEC60870_VISIT(kM_EP_TB_1);
+    QIEC60870_VISIT(kM_EP_TC_1);
+    QIEC60870_VISIT(kM_PS_NA_1);
+    QIEC60870_VISIT(kM_ME_ND_1);
+    QIEC60870_VISIT(kM_SP_TB_1);
+    QIEC60870_VISIT(kM_DP_TB_1);
+    QIEC60870_VISIT(kM_ST_TB_1);
+    QIEC60870_VISIT(kM_BO_TB_1);
+    QIEC60870_VISIT(kM_ME_TD_1);
+    QIEC60870_VISIT(kM_ME_TE_1);
+    QIEC60870_VISIT(kM_ME_TF_1);
+    QIEC60870_VISIT(kM_IT_TB_1);
+    QIEC60870_VISIT(kM_EP_TD_1);
+    QIEC60870_VISIT(kM_EP_TE_1);
+    QIEC60870_VISIT(kM_EP_TF_1);
+    QIEC60870_VISIT(kC_SC_NA_1);
+    QIEC60870_VISIT(kC_DC_NA_1);
+    QIEC60870_VISIT(kC_RC_NA_1);
+    QIEC60870_VISIT(kC_SE_NA_1);
+    QIEC60870_VISIT(kC_SE_NB_1);
+    QIEC60870_VISIT(kC_SE_NC_1);
+    QIEC60870_VISIT(kC_BO_NA_1);
+    QIEC60870_VISIT(kC_SC_TA_1);
+    QIEC60870_VISIT(kC_DC_TA_1);
+    QIEC60870_VISIT(kC_RC_TA_1);
+    QIEC60870_VISIT(kC_SE_TA_1);
+    QIEC60870_VISIT(kC_SE_TB_1);
+    QIEC60870_VISIT(kC_SE_TC_1);
+    QIEC60870_VISIT(kC_BO_TA_1);
+    QIEC60870_VISIT(kM_EI_NA_1);
+    QIEC60870_VISIT(kC_IC_NA_1);
+    QIEC60870_VISIT(kC_CI_NA_1);
+    QIEC60870_VISIT(kC_RD_NA_1);
+    QIEC60870_VISIT(kC_CS_NA_1);
+    QIEC60870_VISIT(kC_TS_NA_1);
+    QIEC60870_VISIT(kC_RP_NA_1);
+    QIEC60870_VISIT(kC_CD_NA_1);
+    QIEC60870_VISIT(kC_TS_TA_1);
+    QIEC60870_VISIT(kP_ME_NA_1);
+    QIEC60870_VISIT(kP_ME_NB_1);
+    QIEC60870_VISIT(kP_ME_NC_1);
+    QIEC60870_VISIT(kP_AC_NA_1);
+#undef QIEC60870_VISIT
+  default:
+    return false;
+  }
+}
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,156 @@
+#include "iec_app_layer_information_element.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+static_assert(typeDescriptor(TypeId::kM_ME_NC_1).elementSize == 5, "");
+static_assert(typeDescriptor(TypeId::kM_ME_TF_1).timeTagOffset() == 5, "");
+static_assert(InformationElement<TypeId::kM_SP_TB_1>::size() == 8, "");
+
+TEST(TypeId, descriptors) {
+  const TypeDescriptor &sp = typeDescriptor(TypeId::kM_SP_NA_1);
+  EXPECT_EQ(sp.typeId, 1);
+  EXPECT_EQ(sp.category, TypeCategory::kProcessMonitor);
+  EXPECT_EQ(sp.elementSize, 1);
+  EXPECT_STREQ(sp.name, "M_SP_NA_1");
+  EXPECT_TRUE(sp.isKnown());
+
+  const TypeDescriptor &me = typeDescriptor(TypeId::kM_ME_TD_1);
+  EXPECT_EQ(me.elementSize, 10);
+  EXPECT_EQ(me.timeTag, TimeTag::kCP56Time2a);
+  EXPECT_EQ(me.quality, QualityLayout::kQDS);
+  EXPECT_EQ(me.qualityOffset, 2);
+
+  EXPECT_EQ(typeDescriptor(TypeId::kC_IC_NA_1).category,
+            TypeCategory::kSystemControl);
+  EXPECT_EQ(typeDescriptor(TypeId::kF_SG_NA_1).isVariableSize, true);
+
+  EXPECT_EQ(typeDescriptor(uint8_t(0)).category, TypeCategory::kReserved);
+  EXPECT_EQ(typeDescriptor(uint8_t(22)).category, TypeCategory::kReserved);
+  EXPECT_EQ(typeDescriptor(uint8_t(200)).category, TypeCategory::kPrivate);
+  EXPECT_FALSE(typeDescriptor(uint8_t(200)).isKnown());
+}
+
+TEST(TypeId, every_id_has_its_own_descriptor) {
+  for (int id = 1; id < 128; ++id) {
+    const TypeDescriptor &type = typeDescriptor(static_cast<uint8_t>(id));
+    if (type.category != TypeCategory::kReserved) {
+      EXPECT_EQ(type.typeId, id);
+    }
+  }
+}
+
+TEST(InformationElement, validate) {
+  /// M_ME_NC_1, 2 objects, 3 octet ioa
+  std::vector<uint8_t> data = {0x0d, 0x02, 0x03, 0x00, 0x01, 0x00,
+                               0x01, 0x00, 0x00, 0,    0,    0,
+                               0,    0,    0x02, 0x00, 0x00, 0,
+                               0,    0,    0,    0};
+  AsduView asdu(data.data(), data.size());
+  EXPECT_EQ(asdu.validate(), AsduParseErr::kNoError);
+
+  /// divides evenly but is not the element size of M_ME_NC_1
+  AsduView wrong(data.data(), data.size() - 2);
+  EXPECT_EQ(wrong.error(), AsduParseErr::kNoError);
+  EXPECT_EQ(wrong.validate(), AsduParseErr::kBadLength);
+
+  data[0] = 22;
+  EXPECT_EQ(asdu.validate(), AsduParseErr::kUnknownTypeId);
+  data[0] = 200;
+  EXPECT_EQ(asdu.validate(), AsduParseErr::kNoError);
+  EXPECT_EQ(AsduView(data.data(), 3).validate(), AsduParseErr::kTooShort);
+}
+
+TEST(InformationElement, short_float_sequence) {
+  /// M_ME_NC_1, SQ=1, 2 objects from ioa 0x000100
+  std::vector<uint8_t> data = {0x0d, 0x82, 0x03, 0x00, 0x01, 0x00,
+                               0x00, 0x01, 0x00};
+  float values[] = {1.5f, -2.25f};
+  for (float value : values) {
+    uint8_t raw[4];
+    std::memcpy(raw, &value, sizeof(raw));
+    data.insert(data.end(), raw, raw + 4);
+    data.push_back(0x80);
+  }
+  AsduView asdu(data.data(), data.size());
+  ASSERT_EQ(asdu.validate(), AsduParseErr::kNoError);
+
+  std::vector<uint32_t> addresses;
+  std::vector<float> decoded;
+  forEachElement<TypeId::kM_ME_NC_1>(
+      asdu, [&](uint32_t address,
+                const InformationElement<TypeId::kM_ME_NC_1>::Value &v) {
+        addresses.push_back(address);
+        decoded.push_back(v.info.value);
+        EXPECT_EQ(v.info.quality, 0x80);
+      });
+  EXPECT_THAT(addresses, ElementsAre(0x100u, 0x101u));
+  EXPECT_THAT(decoded, ElementsAre(1.5f, -2.25f));
+}
+
+TEST(InformationElement, time_tagged) {
+  /// M_SP_TB_1, ioa 5, SPI on, CP56Time2a 2021-03-04 05:06:07.890 IV
+  std::vector<uint8_t> data = {0x1e, 0x01, 0x03, 0x00, 0x01, 0x00, 0x05,
+                               0x00, 0x00, 0x01, 0xd2, 0x1e, 0x86, 0x05,
+                               0x84, 0x03, 0x15};
+  auto value = InformationElement<TypeId::kM_SP_TB_1>::decode(data.data() + 9);
+  EXPECT_EQ(value.info.value, true);
+  EXPECT_EQ(value.info.quality, 0);
+  EXPECT_EQ(value.time.milliseconds, 7890);
+  EXPECT_EQ(value.time.minute, 6);
+  EXPECT_EQ(value.time.invalid, true);
+  EXPECT_EQ(value.time.hour, 5);
+  EXPECT_EQ(value.time.dayOfMonth, 4);
+  EXPECT_EQ(value.time.dayOfWeek, 4);
+  EXPECT_EQ(value.time.month, 3);
+  EXPECT_EQ(value.time.year, 21);
+
+  uint8_t encoded[7];
+  encodeCp56Time2a(value.time, encoded);
+  EXPECT_EQ(0, std::memcmp(encoded, data.data() + 10, sizeof(encoded)));
+}
+
+TEST(InformationElement, commands) {
+  EXPECT_EQ(InformationElement<TypeId::kC_IC_NA_1>::decode(
+                std::vector<uint8_t>{0x14}.data())
+                .info.qualifier,
+            20);
+
+  uint8_t sco = 0x81;
+  auto sc = InformationElement<TypeId::kC_SC_NA_1>::decode(&sco);
+  EXPECT_EQ(sc.info.value, true);
+  EXPECT_EQ(sc.info.select, true);
+  EXPECT_EQ(sc.info.qualifier, 0);
+
+  uint8_t vti[] = {0x7f, 0x00};
+  EXPECT_EQ(InformationElement<TypeId::kM_ST_NA_1>::decode(vti).info.value,
+            -1);
+}
+
+namespace {
+struct CountingVisitor {
+  template <typename Value> void operator()(uint32_t, const Value &) {
+    ++count;
+  }
+  int count = 0;
+};
+} // namespace
+
+TEST(InformationElement, visit_elements) {
+  /// C_IC_NA_1 activation, QOI 20
+  std::vector<uint8_t> data = {0x64, 0x01, 0x06, 0x00, 0x01,
+                               0x00, 0x00, 0x00, 0x00, 0x14};
+  CountingVisitor visitor;
+  EXPECT_TRUE(visitElements(AsduView(data.data(), data.size()), visitor));
+  EXPECT_EQ(visitor.count, 1);
+
+  data.push_back(0);
+  EXPECT_FALSE(visitElements(AsduView(data.data(), data.size()), visitor));
+  EXPECT_EQ(visitor.count, 1);
+}
@@ -0,0 +1,348 @@
+#ifndef IEC_APP_LAYER_INFORMATION_OBJECT_BATCH_H
+#define IEC_APP_LAYER_INFORMATION_OBJECT_BATCH_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "iec_app_layer_asdu.h"
+#include "iec_app_layer_information_element.h"
+#include "iec_app_layer_time.h"
+#include "iec_app_layer_type_id.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/// timestamp of the rows of types without a time tag
+const int64_t kNoTimestamp = INT64_MIN;
+
+/**
+ * @brief the value column of InformationObjectBatch, which member is set
+ * depends on the type id of the row
+ *
+ * real: normalized (scaled to -1.0 .. 1.0), short float, setpoints and
+ * parameters of those
+ * bits: bitstrings, packed single points (status | changed << 16)
+ * integer: everything else, e.g. SPI, DPI, VTI, scaled values, BCR counter
+ * readings, event states, command states and qualifiers
+ */
+union ObjectValue {
+  float real;
+  int32_t integer;
+  uint32_t bits;
+};
+
+namespace detail {
+inline void setInteger(int32_t value, ObjectValue &column) {
+  column.integer = value;
+}
+inline void setReal(float value, ObjectValue &column) { column.real = value; }
+inline void setBits(uint32_t value, ObjectValue &column) {
+  column.bits = value;
+}
+
+/**
+ * @brief the value and the quality octet of a row,
+ * quality is QDS, the BCR flags, or the command qualifier with S/E in bit 7
+ */
+inline void toColumns(const NoInformation &, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(0, value);
+  quality = 0;
+}
+inline void toColumns(const SinglePoint &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const DoublePoint &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const StepPosition &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const Bitstring32 &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setBits(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const NormalizedValue &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value(), value);
+  quality = info.quality;
+}
+inline void toColumns(const NormalizedValueWithoutQuality &info,
+                      ObjectValue &value, uint8_t &quality) {
+  setReal(info.value(), value);
+  quality = 0;
+}
+inline void toColumns(const ScaledValue &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const ShortFloat &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value, value);
+  quality = info.quality;
+}
+inline void toColumns(const IntegratedTotal &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = static_cast<uint8_t>(info.sequence | (info.carry ? 0x20 : 0) |
+                                 (info.adjusted ? 0x40 : 0) |
+                                 (info.invalid ? 0x80 : 0));
+}
+inline void toColumns(const ProtectionEvent &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.state, value);
+  quality = info.quality;
+}
+inline void toColumns(const PackedStartEvents &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.events, value);
+  quality = info.quality;
+}
+inline void toColumns(const PackedOutputCircuit &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.circuits, value);
+  quality = info.quality;
+}
+inline void toColumns(const PackedSinglePoints &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setBits(info.status | (static_cast<uint32_t>(info.changed) << 16), value);
+  quality = info.quality;
+}
+template <typename Command>
+inline void commandToColumns(int32_t state, const Command &info,
+                             ObjectValue &value, uint8_t &quality) {
+  setInteger(state, value);
+  quality = static_cast<uint8_t>(info.qualifier | (info.select ? 0x80 : 0));
+}
+inline void toColumns(const SingleCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  commandToColumns(info.value, info, value, quality);
+}
+inline void toColumns(const DoubleCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  commandToColumns(info.value, info, value, quality);
+}
+inline void toColumns(const RegulatingStepCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  commandToColumns(info.value, info, value, quality);
+}
+inline void toColumns(const SetpointNormalized &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value(), value);
+  quality = static_cast<uint8_t>(info.qualifier | (info.select ? 0x80 : 0));
+}
+inline void toColumns(const SetpointScaled &info, ObjectValue &value,
+                      uint8_t &quality) {
+  commandToColumns(info.value, info, value, quality);
+}
+inline void toColumns(const SetpointFloat &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value, value);
+  quality = static_cast<uint8_t>(info.qualifier | (info.select ? 0x80 : 0));
+}
+inline void toColumns(const Bitstring32Command &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setBits(info.value, value);
+  quality = 0;
+}
+inline void toColumns(const EndOfInitialization &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.cause, value);
+  quality = info.afterParameterChange ? 0x80 : 0;
+}
+inline void toColumns(const InterrogationCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.qualifier, value);
+  quality = 0;
+}
+inline void toColumns(const CounterInterrogationCommand &info,
+                      ObjectValue &value, uint8_t &quality) {
+  setInteger(info.request, value);
+  quality = info.freeze;
+}
+inline void toColumns(const TestCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.pattern, value);
+  quality = 0;
+}
+inline void toColumns(const TestCommandCounter &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.counter, value);
+  quality = 0;
+}
+inline void toColumns(const ResetProcessCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.qualifier, value);
+  quality = 0;
+}
+inline void toColumns(const DelayAcquisitionCommand &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.delayMilliseconds, value);
+  quality = 0;
+}
+inline void toColumns(const ParameterNormalized &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value(), value);
+  quality = info.qualifier;
+}
+inline void toColumns(const ParameterScaled &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.value, value);
+  quality = info.qualifier;
+}
+inline void toColumns(const ParameterFloat &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setReal(info.value, value);
+  quality = info.qualifier;
+}
+inline void toColumns(const ParameterActivation &info, ObjectValue &value,
+                      uint8_t &quality) {
+  setInteger(info.qualifier, value);
+  quality = 0;
+}
+} // namespace detail
+
+/**
+ * @brief Decoded information objects stored column-wise: address, type id,
+ * value, quality and timestamp, one row per object, rows of any number of
+ * asdus of any type. clear() keeps the capacity, so a batch reused from
+ * frame to frame stops allocating once it has grown to the largest burst.
+ * one batch per thread
+ */
+class InformationObjectBatch {
+public:
+  void reserve(size_t n) {
+    addresses_.reserve(n);
+    typeIds_.reserve(n);
+    values_.reserve(n);
+    qualities_.reserve(n);
+    timestamps_.reserve(n);
+  }
+
+  /**
+   * @brief drop the rows, keep the capacity
+   */
+  void clear() {
+    addresses_.clear();
+    typeIds_.clear();
+    values_.clear();
+    qualities_.clear();
+    timestamps_.clear();
+  }
+
+  size_t size() const { return addresses_.size(); }
+  size_t capacity() const { return addresses_.capacity(); }
+  bool empty() const { return addresses_.empty(); }
+
+  /**
+   * @brief append a row per information object
+   *
+   * @param asdu
+   * @param referenceMs completes CP24Time2a tags, see toEpochMilliseconds()
+   * @return the validate() error, kUnknownTypeId if there is no decoder for
+   * the type id. nothing is appended on error
+   */
+  AsduParseErr append(const AsduView &asdu, int64_t referenceMs = 0) {
+    AsduParseErr err = asdu.validate();
+    if (err != AsduParseErr::kNoError) {
+      return err;
+    }
+    /// grow all columns at once and geometrically, appending is amortized
+    /// O(1) per object
+    const size_t needed = size() + asdu.numberOfObjects();
+    if (needed > capacity()) {
+      reserve(std::max(2 * capacity(), needed));
+    }
+    currentType_ = asdu.typeId();
+    Appender appender = {this, referenceMs};
+    if (!visitElements(asdu, appender)) {
+      return AsduParseErr::kUnknownTypeId;
+    }
+    return AsduParseErr::kNoError;
+  }
+
+  /**
+   * @brief append one row
+   *
+   * @param address
+   * @param value
+   * @param referenceMs completes CP24Time2a tags
+   */
+  template <TypeId Id>
+  void append(uint32_t address,
+              const typename InformationElement<Id>::Value &value,
+              int64_t referenceMs = 0) {
+    addRow_(address, static_cast<uint8_t>(Id), value, referenceMs);
+  }
+
+  const uint32_t *addresses() const { return addresses_.data(); }
+  const uint8_t *typeIds() const { return typeIds_.data(); }
+  const ObjectValue *values() const { return values_.data(); }
+  const uint8_t *qualities() const { return qualities_.data(); }
+  /// milliseconds since the unix epoch, or kNoTimestamp
+  const int64_t *timestamps() const { return timestamps_.data(); }
+
+private:
+  struct Appender {
+    template <typename Value>
+    void operator()(uint32_t address, const Value &v) {
+      batch->addRow_(address, batch->currentType_, v, referenceMs);
+    }
+    InformationObjectBatch *batch;
+    int64_t referenceMs;
+  };
+  friend struct Appender;
+
+  template <typename Info>
+  void addRow_(uint32_t address, uint8_t type,
+               const Element<Info, NoTime> &element, int64_t) {
+    pushColumns_(address, type, element.info, kNoTimestamp);
+  }
+  template <typename Info>
+  void addRow_(uint32_t address, uint8_t type,
+               const Element<Info, Cp24Time2a> &element, int64_t referenceMs) {
+    pushColumns_(address, type, element.info,
+                 toEpochMilliseconds(element.time, referenceMs));
+  }
+  template <typename Info>
+  void addRow_(uint32_t address, uint8_t type,
+               const Element<Info, Cp56Time2a> &element, int64_t) {
+    pushColumns_(address, type, element.info,
+                 toEpochMilliseconds(element.time));
+  }
+
+  template <typename Info>
+  void pushColumns_(uint32_t address, uint8_t type, const Info &info,
+                    int64_t timestamp) {
+    ObjectValue value;
+    uint8_t quality;
+    detail::toColumns(info, value, quality);
+    addresses_.push_back(address);
+    typeIds_.push_back(type);
+    values_.push_back(value);
+    qualities_.push_back(quality);
+    timestamps_.push_back(timestamp);
+  }
+
+  std::vector<uint32_t> addresses_;
+  std::vector<uint8_t> typeIds_;
+  std::vector<ObjectValue> values_;
+  std::vector<uint8_t> qualities_;
+  std::vector<int64_t> timestamps_;
+  uint8_t currentType_ = 0;
+};
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
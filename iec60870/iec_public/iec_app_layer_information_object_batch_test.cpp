@@ -0,0 +1,122 @@
+#include "iec_app_layer_asdu_writer.h"
+#include "iec_app_layer_information_object_batch.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+TEST(InformationObjectBatch, append_asdus_of_several_types) {
+  InformationObjectBatch batch;
+
+  /// M_ME_NC_1, SQ=1, 2 objects from ioa 0x000100
+  std::vector<uint8_t> floats = {0x0d, 0x82, 0x03, 0x00, 0x01, 0x00,
+                                 0x00, 0x01, 0x00, 0x00, 0x00, 0xc0,
+                                 0x3f, 0x00, 0x00, 0x00, 0x10, 0xc0,
+                                 0x80};
+  ASSERT_EQ(batch.append(AsduView(floats.data(), floats.size())),
+            AsduParseErr::kNoError);
+
+  InformationElement<TypeId::kM_DP_TB_1>::Value dp;
+  dp.info.value = 2;
+  dp.info.quality = 0x10;
+  dp.time = fromEpochMilliseconds(1614834367890);
+  InformationElement<TypeId::kM_IT_NA_1>::Value it;
+  it.info.value = -5;
+  it.info.sequence = 3;
+  it.info.carry = true;
+  it.info.adjusted = false;
+  it.info.invalid = false;
+  AsduWriter writer;
+  writer.begin(TypeId::kM_DP_TB_1, Cause::kSpontaneous, 1)
+      .add<TypeId::kM_DP_TB_1>(7, dp);
+  ASSERT_EQ(batch.append(writer.view()), AsduParseErr::kNoError);
+  batch.append<TypeId::kM_IT_NA_1>(9, it);
+
+  ASSERT_EQ(batch.size(), 4u);
+  EXPECT_THAT(std::vector<uint32_t>(batch.addresses(), batch.addresses() + 4),
+              ElementsAre(0x100u, 0x101u, 7u, 9u));
+  EXPECT_THAT(std::vector<uint8_t>(batch.typeIds(), batch.typeIds() + 4),
+              ElementsAre(13, 13, 31, 15));
+  EXPECT_EQ(batch.values()[0].real, 1.5f);
+  EXPECT_EQ(batch.values()[1].real, -2.25f);
+  EXPECT_EQ(batch.values()[2].integer, 2);
+  EXPECT_EQ(batch.values()[3].integer, -5);
+  EXPECT_THAT(std::vector<uint8_t>(batch.qualities(), batch.qualities() + 4),
+              ElementsAre(0x00, 0x80, 0x10, 0x23));
+  EXPECT_EQ(batch.timestamps()[0], kNoTimestamp);
+  EXPECT_EQ(batch.timestamps()[2], 1614834367890);
+  EXPECT_EQ(batch.timestamps()[3], kNoTimestamp);
+}
+
+TEST(InformationObjectBatch, cp24_uses_reference) {
+  InformationElement<TypeId::kM_SP_TA_1>::Value sp;
+  sp.info.value = true;
+  sp.info.quality = 0;
+  sp.time = toCp24Time2a(1614834367890);
+  AsduWriter writer;
+  writer.begin(TypeId::kM_SP_TA_1, Cause::kSpontaneous, 1)
+      .add<TypeId::kM_SP_TA_1>(1, sp);
+
+  InformationObjectBatch batch;
+  ASSERT_EQ(batch.append(writer.view(), 1614834367890 + 1000),
+            AsduParseErr::kNoError);
+  EXPECT_EQ(batch.timestamps()[0], 1614834367890);
+  EXPECT_EQ(batch.values()[0].integer, 1);
+}
+
+TEST(InformationObjectBatch, errors_append_nothing) {
+  InformationObjectBatch batch;
+  std::vector<uint8_t> bad = {0x0d, 0x01, 0x03, 0x00, 0x01, 0x00, 0x01};
+  EXPECT_EQ(batch.append(AsduView(bad.data(), bad.size())),
+            AsduParseErr::kBadLength);
+  /// file transfer has no decoder
+  std::vector<uint8_t> file = {0x7d, 0x01, 0x0d, 0x00, 0x01,
+                               0x00, 0x01, 0x00, 0x00, 0x01};
+  EXPECT_EQ(batch.append(AsduView(file.data(), file.size())),
+            AsduParseErr::kUnknownTypeId);
+  EXPECT_TRUE(batch.empty());
+}
+
+TEST(InformationObjectBatch, grows_geometrically) {
+  /// M_ME_NC_1, SQ=1, 2 objects from ioa 0x000100
+  std::vector<uint8_t> floats = {0x0d, 0x82, 0x03, 0x00, 0x01, 0x00,
+                                 0x00, 0x01, 0x00, 0x00, 0x00, 0xc0,
+                                 0x3f, 0x00, 0x00, 0x00, 0x10, 0xc0,
+                                 0x80};
+  InformationObjectBatch batch;
+  size_t growths = 0;
+  size_t capacity = batch.capacity();
+  for (int i = 0; i < 1000; ++i) {
+    ASSERT_EQ(batch.append(AsduView(floats.data(), floats.size())),
+              AsduParseErr::kNoError);
+    if (batch.capacity() != capacity) {
+      capacity = batch.capacity();
+      ++growths;
+    }
+  }
+  EXPECT_EQ(batch.size(), 2000u);
+  EXPECT_LE(growths, 11u);
+}
+
+TEST(InformationObjectBatch, clear_keeps_capacity) {
+  InformationObjectBatch batch;
+  InformationElement<TypeId::kM_ME_NB_1>::Value value;
+  value.info.value = 1;
+  value.info.quality = 0;
+  for (uint32_t i = 0; i < 1000; ++i) {
+    batch.append<TypeId::kM_ME_NB_1>(i, value);
+  }
+  size_t capacity = batch.capacity();
+  batch.clear();
+  EXPECT_EQ(batch.size(), 0u);
+  EXPECT_EQ(batch.capacity(), capacity);
+  const uint32_t *addresses = batch.addresses();
+  for (uint32_t i = 0; i < 1000; ++i) {
+    batch.append<TypeId::kM_ME_NB_1>(i, value);
+  }
+  EXPECT_EQ(batch.addresses(), addresses);
+}
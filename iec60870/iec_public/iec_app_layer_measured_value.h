@@ -0,0 +1,255 @@
+#ifndef IEC_APP_LAYER_MEASURED_VALUE_H
+#define IEC_APP_LAYER_MEASURED_VALUE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "iec_app_layer_asdu.h"
+#include "iec_app_layer_type_id.h"
+#include "iec_simd.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/**
+ * @brief the objects of a M_ME_NA_1, M_ME_NB_1 or M_ME_NC_1 asdu as struct
+ * of arrays, filled by decodeMeasuredValues(). the capacity is the largest
+ * number of objects a vsq can hold
+ */
+struct MeasuredValueBatch {
+  enum { kCapacity = 127 };
+
+  TypeId typeId;
+  size_t size;
+  uint32_t address[kCapacity];
+  /// normalized values scaled to -1.0 .. 1.0, scaled values as is
+  float value[kCapacity];
+  /// NVA/SVA as received, 0 for short floats
+  int16_t raw[kCapacity];
+  /// QDS
+  uint8_t quality[kCapacity];
+};
+
+namespace detail {
+
+/**
+ * @brief 3 octet elements, a 16 bit value followed by the QDS
+ */
+inline void splitInt16Scalar(const uint8_t *elements, size_t n, float scale,
+                             int16_t *raw, float *value, uint8_t *quality) {
+  for (size_t i = 0; i < n; ++i, elements += 3) {
+    raw[i] = static_cast<int16_t>(elements[0] | (elements[1] << 8));
+    value[i] = raw[i] * scale;
+    quality[i] = elements[2];
+  }
+}
+
+/**
+ * @brief 5 octet elements, an IEEE STD 754 float followed by the QDS
+ */
+inline void splitFloatScalar(const uint8_t *elements, size_t n, int16_t *raw,
+                             float *value, uint8_t *quality) {
+  for (size_t i = 0; i < n; ++i, elements += 5) {
+    uint32_t bits = readLE(elements, 4);
+    std::memcpy(value + i, &bits, sizeof(float));
+    raw[i] = 0;
+    quality[i] = elements[4];
+  }
+}
+
+#ifdef QIEC60870_HAS_AVX2_TARGET
+/**
+ * @brief pshufb moves the values of 4 elements into the low 8 octets and
+ * their QDS into the next 4. a 16 octet load covers 5 elements, so the loop
+ * stops while 16 octets are still left and the scalar code takes the rest
+ */
+__attribute__((target("ssse3"))) inline void
+splitInt16Ssse3(const uint8_t *elements, size_t n, float scale, int16_t *raw,
+                float *value, uint8_t *quality) {
+  const __m128i split =
+      _mm_setr_epi8(0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+  const __m128 factor = _mm_set1_ps(scale);
+  size_t i = 0;
+  for (; (i + 4) * 3 + 4 <= n * 3; i += 4) {
+    __m128i v = _mm_shuffle_epi8(
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(elements + i * 3)),
+        split);
+    _mm_storel_epi64(reinterpret_cast<__m128i *>(raw + i), v);
+    /// sign extend the 16 bit values
+    __m128i wide = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+    _mm_storeu_ps(value + i, _mm_mul_ps(_mm_cvtepi32_ps(wide), factor));
+    uint32_t qds = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8)));
+    std::memcpy(quality + i, &qds, sizeof(qds));
+  }
+  splitInt16Scalar(elements + i * 3, n - i, scale, raw + i, value + i,
+                   quality + i);
+}
+
+/**
+ * @brief as splitInt16Ssse3() with 8 elements per step, one 16 octet load
+ * per 128 bit lane
+ */
+__attribute__((target("avx2"))) inline void
+splitInt16Avx2(const uint8_t *elements, size_t n, float scale, int16_t *raw,
+               float *value, uint8_t *quality) {
+  const __m256i split = _mm256_setr_epi8(
+      0, 1, 3, 4, 6, 7, 9, 10, 2, 5, 8, 11, -1, -1, -1, -1, 0, 1, 3, 4, 6, 7,
+      9, 10, 2, 5, 8, 11, -1, -1, -1, -1);
+  const __m256 factor = _mm256_set1_ps(scale);
+  size_t i = 0;
+  for (; (i + 8) * 3 + 4 <= n * 3; i += 8) {
+    const uint8_t *p = elements + i * 3;
+    __m256i v = _mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i *>(p))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 12)), 1);
+    v = _mm256_shuffle_epi8(v, split);
+    /// qword 0 and 2 hold the values, 1 and 3 the QDS
+    v = _mm256_permute4x64_epi64(v, 0xd8);
+    __m128i values = _mm256_castsi256_si128(v);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(raw + i), values);
+    _mm256_storeu_ps(value + i,
+                     _mm256_mul_ps(_mm256_cvtepi32_ps(
+                                       _mm256_cvtepi16_epi32(values)),
+                                   factor));
+    __m128i qds = _mm256_extracti128_si256(v, 1);
+    uint32_t lo = static_cast<uint32_t>(_mm_cvtsi128_si32(qds));
+    uint32_t hi =
+        static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(qds, 8)));
+    std::memcpy(quality + i, &lo, sizeof(lo));
+    std::memcpy(quality + i + 4, &hi, sizeof(hi));
+  }
+  splitInt16Ssse3(elements + i * 3, n - i, scale, raw + i, value + i,
+                  quality + i);
+}
+
+/**
+ * @brief 4 elements span 20 octets, the fourth float and QDS are taken from
+ * a second load 4 octets further on
+ */
+__attribute__((target("ssse3"))) inline void
+splitFloatSsse3(const uint8_t *elements, size_t n, int16_t *raw, float *value,
+                uint8_t *quality) {
+  const __m128i lowValues =
+      _mm_setr_epi8(0, 1, 2, 3, 5, 6, 7, 8, 10, 11, 12, 13, -1, -1, -1, -1);
+  const __m128i highValues = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                           -1, -1, -1, 11, 12, 13, 14);
+  const __m128i lowQds = _mm_setr_epi8(4, 9, 14, -1, -1, -1, -1, -1, -1, -1,
+                                       -1, -1, -1, -1, -1, -1);
+  const __m128i highQds = _mm_setr_epi8(-1, -1, -1, 15, -1, -1, -1, -1, -1, -1,
+                                        -1, -1, -1, -1, -1, -1);
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    const uint8_t *p = elements + i * 5;
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 4));
+    __m128i floats = _mm_or_si128(_mm_shuffle_epi8(lo, lowValues),
+                                  _mm_shuffle_epi8(hi, highValues));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(value + i), floats);
+    uint32_t qds = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_or_si128(
+        _mm_shuffle_epi8(lo, lowQds), _mm_shuffle_epi8(hi, highQds))));
+    std::memcpy(quality + i, &qds, sizeof(qds));
+    std::memset(raw + i, 0, 4 * sizeof(int16_t));
+  }
+  splitFloatScalar(elements + i * 5, n - i, raw + i, value + i, quality + i);
+}
+#endif
+
+typedef void (*SplitInt16Func)(const uint8_t *, size_t, float, int16_t *,
+                               float *, uint8_t *);
+typedef void (*SplitFloatFunc)(const uint8_t *, size_t, int16_t *, float *,
+                               uint8_t *);
+
+/**
+ * @brief the widest implementation the cpu supports, picked once
+ *
+ * @return
+ */
+inline SplitInt16Func bestSplitInt16() {
+#if defined(QIEC60870_HAS_AVX2_TARGET)
+  if (__builtin_cpu_supports("avx2")) {
+    return splitInt16Avx2;
+  }
+  if (__builtin_cpu_supports("ssse3")) {
+    return splitInt16Ssse3;
+  }
+#endif
+  return splitInt16Scalar;
+}
+
+inline SplitFloatFunc bestSplitFloat() {
+#if defined(QIEC60870_HAS_AVX2_TARGET)
+  if (__builtin_cpu_supports("ssse3")) {
+    return splitFloatSsse3;
+  }
+#endif
+  return splitFloatScalar;
+}
+
+} // namespace detail
+
+/**
+ * @brief decode a M_ME_NA_1, M_ME_NB_1 or M_ME_NC_1 asdu into a batch in one
+ * pass. sequences (SQ=1) are split with SIMD shuffles, the addresses are
+ * base + i. single objects (SQ=0) are decoded one by one
+ *
+ * @param asdu
+ * @param batch
+ * @return the validate() error, kUnknownTypeId for other type ids
+ */
+inline AsduParseErr decodeMeasuredValues(const AsduView &asdu,
+                                         MeasuredValueBatch &batch) {
+  batch.size = 0;
+  AsduParseErr err = asdu.validate();
+  if (err != AsduParseErr::kNoError) {
+    return err;
+  }
+  const TypeId type = static_cast<TypeId>(asdu.typeId());
+  if (type != TypeId::kM_ME_NA_1 && type != TypeId::kM_ME_NB_1 &&
+      type != TypeId::kM_ME_NC_1) {
+    return AsduParseErr::kUnknownTypeId;
+  }
+  batch.typeId = type;
+  const size_t n = asdu.numberOfObjects();
+  const size_t ioaSize = asdu.parameters().ioaSize;
+  const size_t elementSize = typeDescriptor(type).elementSize;
+  const float scale = type == TypeId::kM_ME_NA_1 ? 1.0f / 32768 : 1.0f;
+  const uint8_t *p = asdu.objects();
+
+  if (asdu.isSequence()) {
+    if (n == 0) {
+      return AsduParseErr::kNoError;
+    }
+    const uint32_t base = detail::readLE(p, ioaSize);
+    for (size_t i = 0; i < n; ++i) {
+      batch.address[i] = base + static_cast<uint32_t>(i);
+    }
+    p += ioaSize;
+    if (type == TypeId::kM_ME_NC_1) {
+      static const detail::SplitFloatFunc split = detail::bestSplitFloat();
+      split(p, n, batch.raw, batch.value, batch.quality);
+    } else {
+      static const detail::SplitInt16Func split = detail::bestSplitInt16();
+      split(p, n, scale, batch.raw, batch.value, batch.quality);
+    }
+  } else {
+    for (size_t i = 0; i < n; ++i, p += ioaSize + elementSize) {
+      batch.address[i] = detail::readLE(p, ioaSize);
+      if (type == TypeId::kM_ME_NC_1) {
+        detail::splitFloatScalar(p + ioaSize, 1, batch.raw + i,
+                                 batch.value + i, batch.quality + i);
+      } else {
+        detail::splitInt16Scalar(p + ioaSize, 1, scale, batch.raw + i,
+                                 batch.value + i, batch.quality + i);
+      }
+    }
+  }
+  batch.size = n;
+  return AsduParseErr::kNoError;
+}
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,83 @@
+#include "iec_app_layer_information_element.h"
+#include "iec_app_layer_measured_value.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace QIEC60870::asdu;
+
+namespace {
+/// SQ=1 asdu of n objects from ioa 1
+std::vector<uint8_t> makeSequence(TypeId type, size_t n) {
+  std::vector<uint8_t> data = {static_cast<uint8_t>(type),
+                               static_cast<uint8_t>(0x80 | n),
+                               0x14,
+                               0x00,
+                               0x01,
+                               0x00,
+                               0x01,
+                               0x00,
+                               0x00};
+  data.resize(data.size() + n * typeDescriptor(type).elementSize, 0x11);
+  return data;
+}
+
+const TypeId kTypes[] = {TypeId::kM_ME_NA_1, TypeId::kM_ME_NB_1,
+                         TypeId::kM_ME_NC_1};
+} // namespace
+
+/// args: type index, number of objects
+static void BM_DecodeMeasuredValues(benchmark::State &state) {
+  auto data = makeSequence(kTypes[state.range(0)], state.range(1));
+  AsduView asdu(data.data(), data.size());
+  MeasuredValueBatch batch;
+  for (auto _ : state) {
+    decodeMeasuredValues(asdu, batch);
+    benchmark::DoNotOptimize(batch.value);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+/// the per element decoder into the same batch, for comparison
+template <TypeId Id>
+static void BM_ForEachElement(benchmark::State &state) {
+  auto data = makeSequence(Id, state.range(1));
+  AsduView asdu(data.data(), data.size());
+  MeasuredValueBatch batch;
+  for (auto _ : state) {
+    size_t i = 0;
+    forEachElement<Id>(
+        asdu, [&](uint32_t address,
+                  const typename InformationElement<Id>::Value &element) {
+          batch.address[i] = address;
+          batch.value[i] = static_cast<float>(element.info.value());
+          batch.quality[i] = element.info.quality;
+          ++i;
+        });
+    benchmark::DoNotOptimize(batch.value);
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+
+static void Sizes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"type", "objects"});
+  for (int type = 0; type < 3; ++type) {
+    for (int n : {8, 32, 120}) {
+      b->Args({type, n});
+    }
+  }
+}
+
+static void NormalizedSizes(benchmark::internal::Benchmark *b) {
+  b->ArgNames({"type", "objects"});
+  for (int n : {8, 32, 120}) {
+    b->Args({0, n});
+  }
+}
+
+BENCHMARK(BM_DecodeMeasuredValues)->Apply(Sizes);
+BENCHMARK_TEMPLATE(BM_ForEachElement, TypeId::kM_ME_NA_1)
+    ->Apply(NormalizedSizes);
@@ -0,0 +1,148 @@
+#include "iec_app_layer_information_element.h"
+#include "iec_app_layer_measured_value.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+namespace {
+/**
+ * @brief a 104 asdu of n objects, SQ=1 from ioa 0x010203 or one address
+ * per object
+ */
+std::vector<uint8_t> makeAsdu(TypeId type, size_t n, bool sequence) {
+  std::vector<uint8_t> data = {static_cast<uint8_t>(type),
+                               static_cast<uint8_t>(n | (sequence ? 0x80 : 0)),
+                               0x14, 0x00, 0x01, 0x00};
+  const size_t elementSize = typeDescriptor(type).elementSize;
+  uint32_t x = 0x12345678;
+  for (size_t i = 0; i < n; ++i) {
+    if (!sequence || i == 0) {
+      uint32_t address = 0x010203 + static_cast<uint32_t>(i * 7);
+      data.push_back(static_cast<uint8_t>(address));
+      data.push_back(static_cast<uint8_t>(address >> 8));
+      data.push_back(static_cast<uint8_t>(address >> 16));
+    }
+    for (size_t j = 0; j < elementSize; ++j) {
+      x = x * 1103515245 + 12345;
+      data.push_back(static_cast<uint8_t>(x >> 16));
+    }
+    if (type == TypeId::kM_ME_NC_1) {
+      /// keep the floats finite so they compare equal
+      data[data.size() - 2] &= 0x3f;
+    }
+  }
+  return data;
+}
+
+template <TypeId Id> void expectSameAsElements(const AsduView &asdu) {
+  MeasuredValueBatch batch;
+  ASSERT_EQ(decodeMeasuredValues(asdu, batch), AsduParseErr::kNoError);
+  ASSERT_EQ(batch.size, asdu.numberOfObjects());
+  EXPECT_EQ(batch.typeId, Id);
+  size_t i = 0;
+  forEachElement<Id>(
+      asdu, [&](uint32_t address,
+                const typename InformationElement<Id>::Value &element) {
+        EXPECT_EQ(batch.address[i], address) << i;
+        EXPECT_EQ(batch.quality[i], element.info.quality) << i;
+        ++i;
+      });
+}
+} // namespace
+
+TEST(MeasuredValue, normalized_sequence) {
+  /// M_ME_NA_1, SQ=1, 0x4000 and 0x8000
+  std::vector<uint8_t> data = {0x09, 0x82, 0x14, 0x00, 0x01, 0x00, 0x0a,
+                               0x00, 0x00, 0x00, 0x40, 0x00, 0x00, 0x80,
+                               0x80};
+  MeasuredValueBatch batch;
+  ASSERT_EQ(decodeMeasuredValues(AsduView(data.data(), data.size()), batch),
+            AsduParseErr::kNoError);
+  ASSERT_EQ(batch.size, 2u);
+  EXPECT_EQ(batch.address[0], 10u);
+  EXPECT_EQ(batch.address[1], 11u);
+  EXPECT_EQ(batch.raw[0], 0x4000);
+  EXPECT_EQ(batch.raw[1], -32768);
+  EXPECT_EQ(batch.value[0], 0.5f);
+  EXPECT_EQ(batch.value[1], -1.0f);
+  EXPECT_EQ(batch.quality[0], 0x00);
+  EXPECT_EQ(batch.quality[1], 0x80);
+}
+
+TEST(MeasuredValue, matches_element_decoder) {
+  for (bool sequence : {true, false}) {
+    for (size_t n = 0; n <= MeasuredValueBatch::kCapacity; ++n) {
+      auto na = makeAsdu(TypeId::kM_ME_NA_1, n, sequence);
+      expectSameAsElements<TypeId::kM_ME_NA_1>(AsduView(na.data(), na.size()));
+      auto nb = makeAsdu(TypeId::kM_ME_NB_1, n, sequence);
+      expectSameAsElements<TypeId::kM_ME_NB_1>(AsduView(nb.data(), nb.size()));
+      auto nc = makeAsdu(TypeId::kM_ME_NC_1, n, sequence);
+      expectSameAsElements<TypeId::kM_ME_NC_1>(AsduView(nc.data(), nc.size()));
+    }
+  }
+}
+
+TEST(MeasuredValue, implementations_agree) {
+  for (size_t n = 1; n <= MeasuredValueBatch::kCapacity; ++n) {
+    for (TypeId type : {TypeId::kM_ME_NA_1, TypeId::kM_ME_NC_1}) {
+      auto data = makeAsdu(type, n, true);
+      /// exact size, so an over-read shows up under a sanitizer
+      std::vector<uint8_t> elements(data.begin() + 9, data.end());
+      MeasuredValueBatch expected;
+      MeasuredValueBatch actual;
+      if (type == TypeId::kM_ME_NA_1) {
+        detail::splitInt16Scalar(elements.data(), n, 1.0f / 32768,
+                                 expected.raw, expected.value,
+                                 expected.quality);
+      } else {
+        detail::splitFloatScalar(elements.data(), n, expected.raw,
+                                 expected.value, expected.quality);
+      }
+#ifdef QIEC60870_HAS_AVX2_TARGET
+      std::vector<detail::SplitInt16Func> int16Funcs;
+      std::vector<detail::SplitFloatFunc> floatFuncs;
+      if (__builtin_cpu_supports("ssse3")) {
+        int16Funcs.push_back(detail::splitInt16Ssse3);
+        floatFuncs.push_back(detail::splitFloatSsse3);
+      }
+      if (__builtin_cpu_supports("avx2")) {
+        int16Funcs.push_back(detail::splitInt16Avx2);
+      }
+      if (type == TypeId::kM_ME_NA_1) {
+        for (auto func : int16Funcs) {
+          func(elements.data(), n, 1.0f / 32768, actual.raw, actual.value,
+               actual.quality);
+          EXPECT_EQ(0, std::memcmp(actual.raw, expected.raw, n * 2)) << n;
+          EXPECT_EQ(0, std::memcmp(actual.value, expected.value, n * 4)) << n;
+          EXPECT_EQ(0, std::memcmp(actual.quality, expected.quality, n)) << n;
+        }
+      } else {
+        for (auto func : floatFuncs) {
+          func(elements.data(), n, actual.raw, actual.value, actual.quality);
+          EXPECT_EQ(0, std::memcmp(actual.raw, expected.raw, n * 2)) << n;
+          EXPECT_EQ(0, std::memcmp(actual.value, expected.value, n * 4)) << n;
+          EXPECT_EQ(0, std::memcmp(actual.quality, expected.quality, n)) << n;
+        }
+      }
+#endif
+    }
+  }
+}
+
+TEST(MeasuredValue, rejects_other_types) {
+  std::vector<uint8_t> data = {0x01, 0x01, 0x03, 0x00, 0x01,
+                               0x00, 0x01, 0x00, 0x00, 0x01};
+  MeasuredValueBatch batch;
+  EXPECT_EQ(decodeMeasuredValues(AsduView(data.data(), data.size()), batch),
+            AsduParseErr::kUnknownTypeId);
+  data.push_back(0);
+  EXPECT_EQ(decodeMeasuredValues(AsduView(data.data(), data.size()), batch),
+            AsduParseErr::kBadLength);
+  EXPECT_EQ(batch.size, 0u);
+}
@@ -0,0 +1,255 @@
+#ifndef IEC_APP_LAYER_TIME_H
+#define IEC_APP_LAYER_TIME_H
+
+#include <cstdint>
+
+namespace QIEC60870 {
+namespace asdu {
+
+/**
+ * @brief three octet binary time, milliseconds and minutes of the hour
+ */
+struct Cp24Time2a {
+  /// seconds * 1000 + milliseconds, 0..59999
+  uint16_t milliseconds;
+  uint8_t minute;
+  /// IV
+  bool invalid;
+};
+
+/**
+ * @brief seven octet binary time, the year is 0..99 of the century
+ */
+struct Cp56Time2a {
+  /// seconds * 1000 + milliseconds, 0..59999
+  uint16_t milliseconds;
+  uint8_t minute;
+  uint8_t hour;
+  uint8_t dayOfMonth;
+  /// 1 monday .. 7 sunday, 0 if not used
+  uint8_t dayOfWeek;
+  uint8_t month;
+  uint8_t year;
+  /// IV
+  bool invalid;
+  /// SU
+  bool summerTime;
+};
+
+inline Cp24Time2a decodeCp24Time2a(const uint8_t *data) {
+  Cp24Time2a time;
+  time.milliseconds = static_cast<uint16_t>(data[0] | (data[1] << 8));
+  time.minute = data[2] & 0x3f;
+  time.invalid = (data[2] & 0x80) != 0;
+  return time;
+}
+
+inline Cp56Time2a decodeCp56Time2a(const uint8_t *data) {
+  Cp56Time2a time;
+  time.milliseconds = static_cast<uint16_t>(data[0] | (data[1] << 8));
+  time.minute = data[2] & 0x3f;
+  time.invalid = (data[2] & 0x80) != 0;
+  time.hour = data[3] & 0x1f;
+  time.summerTime = (data[3] & 0x80) != 0;
+  time.dayOfMonth = data[4] & 0x1f;
+  time.dayOfWeek = data[4] >> 5;
+  time.month = data[5] & 0x0f;
+  time.year = data[6] & 0x7f;
+  return time;
+}
+
+inline void encodeCp24Time2a(const Cp24Time2a &time, uint8_t *data) {
+  data[0] = static_cast<uint8_t>(time.milliseconds);
+  data[1] = static_cast<uint8_t>(time.milliseconds >> 8);
+  data[2] = (time.minute & 0x3f) | (time.invalid ? 0x80 : 0x00);
+}
+
+inline void encodeCp56Time2a(const Cp56Time2a &time, uint8_t *data) {
+  data[0] = static_cast<uint8_t>(time.milliseconds);
+  data[1] = static_cast<uint8_t>(time.milliseconds >> 8);
+  data[2] = (time.minute & 0x3f) | (time.invalid ? 0x80 : 0x00);
+  data[3] = (time.hour & 0x1f) | (time.summerTime ? 0x80 : 0x00);
+  data[4] = (time.dayOfMonth & 0x1f) | ((time.dayOfWeek & 0x07) << 5);
+  data[5] = time.month & 0x0f;
+  data[6] = time.year & 0x7f;
+}
+
+namespace detail {
+/**
+ * @brief days since 1970-01-01 of a proleptic gregorian date,
+ * H. Hinnant's days_from_civil
+ */
+inline int64_t daysFromCivil(int64_t y, unsigned m, unsigned d) {
+  y -= m <= 2;
+  const int64_t era = (y >= 0 ? y : y - 399) / 400;
+  const unsigned yoe = static_cast<unsigned>(y - era * 400);
+  const unsigned doy = (153 * (m > 2 ? m - 3 : m + 9) + 2) / 5 + d - 1;
+  const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+  return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief inverse of daysFromCivil()
+ */
+inline void civilFromDays(int64_t z, int64_t &y, unsigned &m, unsigned &d) {
+  z += 719468;
+  const int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+  const unsigned doe = static_cast<unsigned>(z - era * 146097);
+  const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+  const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+  const unsigned mp = (5 * doy + 2) / 153;
+  d = doy - (153 * mp + 2) / 5 + 1;
+  m = mp < 10 ? mp + 3 : mp - 9;
+  y = static_cast<int64_t>(yoe) + era * 400 + (m <= 2);
+}
+
+inline int64_t floorDiv(int64_t a, int64_t b) {
+  return a / b - (a % b != 0 && (a < 0) != (b < 0));
+}
+
+const int64_t kMillisecondsPerMinute = 60000;
+const int64_t kMillisecondsPerHour = 3600000;
+const int64_t kMillisecondsPerDay = 86400000;
+} // namespace detail
+
+/**
+ * @brief the cp56 fields as milliseconds since the unix epoch, the year is
+ * taken as 2000 + year. the time is used as is, whatever zone the
+ * station sends, SU only tells it is summer time
+ *
+ * @param time
+ * @return
+ */
+inline int64_t toEpochMilliseconds(const Cp56Time2a &time) {
+  return detail::daysFromCivil(2000 + time.year, time.month,
+                               time.dayOfMonth) *
+             detail::kMillisecondsPerDay +
+         time.hour * detail::kMillisecondsPerHour +
+         time.minute * detail::kMillisecondsPerMinute + time.milliseconds;
+}
+
+inline int64_t toEpochNanoseconds(const Cp56Time2a &time) {
+  return toEpochMilliseconds(time) * 1000000;
+}
+
+/**
+ * @brief the cp56 fields of a time since the unix epoch, with the day of
+ * week set. only the year of the century is kept
+ *
+ * @param ms
+ * @param invalid IV
+ * @param summerTime SU
+ * @return
+ */
+inline Cp56Time2a fromEpochMilliseconds(int64_t ms, bool invalid = false,
+                                        bool summerTime = false) {
+  const int64_t days = detail::floorDiv(ms, detail::kMillisecondsPerDay);
+  int64_t rest = ms - days * detail::kMillisecondsPerDay;
+  int64_t y;
+  unsigned m;
+  unsigned d;
+  detail::civilFromDays(days, y, m, d);
+  Cp56Time2a time;
+  time.hour = static_cast<uint8_t>(rest / detail::kMillisecondsPerHour);
+  rest %= detail::kMillisecondsPerHour;
+  time.minute = static_cast<uint8_t>(rest / detail::kMillisecondsPerMinute);
+  time.milliseconds =
+      static_cast<uint16_t>(rest % detail::kMillisecondsPerMinute);
+  time.dayOfMonth = static_cast<uint8_t>(d);
+  /// 1970-01-01 was a thursday
+  time.dayOfWeek = static_cast<uint8_t>((days % 7 + 7 + 3) % 7 + 1);
+  time.month = static_cast<uint8_t>(m);
+  time.year = static_cast<uint8_t>((y % 100 + 100) % 100);
+  time.invalid = invalid;
+  time.summerTime = summerTime;
+  return time;
+}
+
+inline Cp56Time2a fromEpochNanoseconds(int64_t ns, bool invalid = false,
+                                       bool summerTime = false) {
+  return fromEpochMilliseconds(detail::floorDiv(ns, 1000000), invalid,
+                               summerTime);
+}
+
+/**
+ * @brief cp24 only has the minute of the hour, it is completed with the
+ * hour of reference, or the hour before if that would be later than
+ * reference
+ *
+ * @param time
+ * @param referenceMs usually the time of reception
+ * @return
+ */
+inline int64_t toEpochMilliseconds(const Cp24Time2a &time,
+                                   int64_t referenceMs) {
+  int64_t ms = detail::floorDiv(referenceMs, detail::kMillisecondsPerHour) *
+                   detail::kMillisecondsPerHour +
+               time.minute * detail::kMillisecondsPerMinute +
+               time.milliseconds;
+  return ms > referenceMs ? ms - detail::kMillisecondsPerHour : ms;
+}
+
+inline Cp24Time2a toCp24Time2a(int64_t ms, bool invalid = false) {
+  int64_t rest = ms - detail::floorDiv(ms, detail::kMillisecondsPerHour) *
+                          detail::kMillisecondsPerHour;
+  Cp24Time2a time;
+  time.minute = static_cast<uint8_t>(rest / detail::kMillisecondsPerMinute);
+  time.milliseconds =
+      static_cast<uint16_t>(rest % detail::kMillisecondsPerMinute);
+  time.invalid = invalid;
+  return time;
+}
+
+/**
+ * @brief converts encoded cp56 time tags to epoch time, remembering the
+ * hour of the last tag. the tags of a burst mostly share the hour, then a
+ * conversion is a compare and a few adds instead of the calendar
+ * arithmetic. one converter per thread.
+ * the other direction is fromEpochMilliseconds(), its divisions are by
+ * constants and a cache does not beat it
+ */
+class Cp56Time2aConverter {
+public:
+  /**
+   * @brief
+   *
+   * @param data 7 octets
+   * @return milliseconds since the unix epoch
+   */
+  int64_t toEpochMilliseconds(const uint8_t *data) {
+    /// hour, day of month, month and year without SU, day of week and RES
+    const uint32_t key = (data[3] & 0x1fu) | ((data[4] & 0x1fu) << 8) |
+                         ((data[5] & 0x0fu) << 16) |
+                         ((data[6] & 0x7fu) << 24);
+    const int64_t inHour =
+        (data[2] & 0x3f) * detail::kMillisecondsPerMinute +
+        (data[0] | (data[1] << 8));
+    if (key != key_) {
+      key_ = key;
+      Cp56Time2a time = decodeCp56Time2a(data);
+      time.minute = 0;
+      time.milliseconds = 0;
+      hour_ = asdu::toEpochMilliseconds(time);
+    }
+    return hour_ + inHour;
+  }
+
+  int64_t toEpochNanoseconds(const uint8_t *data) {
+    return toEpochMilliseconds(data) * 1000000;
+  }
+
+  static bool isInvalid(const uint8_t *data) { return (data[2] & 0x80) != 0; }
+  static bool isSummerTime(const uint8_t *data) {
+    return (data[3] & 0x80) != 0;
+  }
+
+private:
+  /// no cp56 time encodes to this key
+  uint32_t key_ = 0xffffffff;
+  int64_t hour_ = 0;
+};
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
@@ -0,0 +1,60 @@
+#include "iec_app_layer_time.h"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+using namespace QIEC60870::asdu;
+
+namespace {
+/// a sequence of events burst, one tag every 3 ms
+std::vector<uint8_t> makeTags(size_t n) {
+  std::vector<uint8_t> tags(n * 7);
+  for (size_t i = 0; i < n; ++i) {
+    encodeCp56Time2a(fromEpochMilliseconds(1614834367890 + 3 * i),
+                     tags.data() + i * 7);
+  }
+  return tags;
+}
+const size_t kTags = 1024;
+} // namespace
+
+static void BM_Cp56ToEpochCalendar(benchmark::State &state) {
+  auto tags = makeTags(kTags);
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < kTags; ++i) {
+      sum += toEpochMilliseconds(decodeCp56Time2a(tags.data() + i * 7));
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kTags);
+}
+
+static void BM_Cp56ToEpochConverter(benchmark::State &state) {
+  auto tags = makeTags(kTags);
+  Cp56Time2aConverter converter;
+  for (auto _ : state) {
+    int64_t sum = 0;
+    for (size_t i = 0; i < kTags; ++i) {
+      sum += converter.toEpochMilliseconds(tags.data() + i * 7);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * kTags);
+}
+
+static void BM_EpochToCp56(benchmark::State &state) {
+  uint8_t data[7];
+  for (auto _ : state) {
+    for (size_t i = 0; i < kTags; ++i) {
+      encodeCp56Time2a(fromEpochMilliseconds(1614834367890 + 3 * i), data);
+      benchmark::DoNotOptimize(data);
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * kTags);
+}
+
+BENCHMARK(BM_Cp56ToEpochCalendar);
+BENCHMARK(BM_Cp56ToEpochConverter);
+BENCHMARK(BM_EpochToCp56);
@@ -0,0 +1,73 @@
+#include "iec_app_layer_time.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace testing;
+using namespace QIEC60870::asdu;
+
+namespace {
+/// 2021-03-04 05:06:07.890, thursday
+const int64_t kKnownMs = 1614834367890;
+const uint8_t kKnownCp56[7] = {0xd2, 0x1e, 0x06, 0x05, 0x84, 0x03, 0x15};
+} // namespace
+
+TEST(Time, cp56_to_epoch) {
+  Cp56Time2a time = decodeCp56Time2a(kKnownCp56);
+  EXPECT_EQ(toEpochMilliseconds(time), kKnownMs);
+  EXPECT_EQ(toEpochNanoseconds(time), kKnownMs * 1000000);
+
+  Cp56Time2a leap = fromEpochMilliseconds(951782400000); // 2000-02-29
+  EXPECT_EQ(leap.year, 0);
+  EXPECT_EQ(leap.month, 2);
+  EXPECT_EQ(leap.dayOfMonth, 29);
+  EXPECT_EQ(leap.dayOfWeek, 2);
+  EXPECT_EQ(toEpochMilliseconds(leap), 951782400000);
+}
+
+TEST(Time, epoch_to_cp56) {
+  Cp56Time2a time = fromEpochNanoseconds(kKnownMs * 1000000 + 999999, true);
+  uint8_t data[7];
+  encodeCp56Time2a(time, data);
+  uint8_t expected[7];
+  std::memcpy(expected, kKnownCp56, sizeof(expected));
+  expected[2] |= 0x80;
+  EXPECT_EQ(0, std::memcmp(data, expected, sizeof(data)));
+  EXPECT_EQ(time.invalid, true);
+  EXPECT_EQ(time.summerTime, false);
+}
+
+TEST(Time, round_trip) {
+  /// 2000-01-01 .. 2099, about a week apart plus some odd milliseconds
+  for (int64_t ms = 946684800000; ms < 4102444800000; ms += 604799999) {
+    EXPECT_EQ(toEpochMilliseconds(fromEpochMilliseconds(ms)), ms) << ms;
+  }
+}
+
+TEST(Time, cp24_completed_with_reference) {
+  const int64_t hour = kKnownMs - kKnownMs % 3600000;
+  Cp24Time2a time = toCp24Time2a(hour + 10 * 60000 + 1234);
+  EXPECT_EQ(time.minute, 10);
+  EXPECT_EQ(time.milliseconds, 1234);
+  EXPECT_EQ(toEpochMilliseconds(time, hour + 11 * 60000),
+            hour + 10 * 60000 + 1234);
+  /// later in the hour than the reference, so from the hour before
+  EXPECT_EQ(toEpochMilliseconds(time, hour + 5 * 60000),
+            hour - 3600000 + 10 * 60000 + 1234);
+}
+
+TEST(Time, converter_matches_calendar) {
+  Cp56Time2aConverter converter;
+  /// steps of 7 minutes and some, crossing hours, days and a year end
+  for (int64_t ms = 1640991600000 - 86400000; ms < 1640991600000 + 86400000;
+       ms += 421357) {
+    uint8_t data[7];
+    encodeCp56Time2a(fromEpochMilliseconds(ms, false, true), data);
+    EXPECT_TRUE(Cp56Time2aConverter::isSummerTime(data));
+    EXPECT_FALSE(Cp56Time2aConverter::isInvalid(data));
+    EXPECT_EQ(converter.toEpochMilliseconds(data), ms);
+    EXPECT_EQ(converter.toEpochNanoseconds(data), ms * 1000000);
+  }
+}
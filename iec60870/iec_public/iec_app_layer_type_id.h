@@ -0,0 +1,344 @@
+#ifndef IEC_APP_LAYER_TYPE_ID_H
+#define IEC_APP_LAYER_TYPE_ID_H
+
+#include <cstddef>
+#include <cstdint>
+
+#include "iec_index_sequence.h"
+
+namespace QIEC60870 {
+namespace asdu {
+
+/**
+ * @brief type identification, the first octet of an asdu
+ */
+enum class TypeId : uint8_t {
+  /// process information in monitor direction
+  kM_SP_NA_1 = 1,
+  kM_SP_TA_1 = 2,
+  kM_DP_NA_1 = 3,
+  kM_DP_TA_1 = 4,
+  kM_ST_NA_1 = 5,
+  kM_ST_TA_1 = 6,
+  kM_BO_NA_1 = 7,
+  kM_BO_TA_1 = 8,
+  kM_ME_NA_1 = 9,
+  kM_ME_TA_1 = 10,
+  kM_ME_NB_1 = 11,
+  kM_ME_TB_1 = 12,
+  kM_ME_NC_1 = 13,
+  kM_ME_TC_1 = 14,
+  kM_IT_NA_1 = 15,
+  kM_IT_TA_1 = 16,
+  kM_EP_TA_1 = 17,
+  kM_EP_TB_1 = 18,
+  kM_EP_TC_1 = 19,
+  kM_PS_NA_1 = 20,
+  kM_ME_ND_1 = 21,
+  kM_SP_TB_1 = 30,
+  kM_DP_TB_1 = 31,
+  kM_ST_TB_1 = 32,
+  kM_BO_TB_1 = 33,
+  kM_ME_TD_1 = 34,
+  kM_ME_TE_1 = 35,
+  kM_ME_TF_1 = 36,
+  kM_IT_TB_1 = 37,
+  kM_EP_TD_1 = 38,
+  kM_EP_TE_1 = 39,
+  kM_EP_TF_1 = 40,
+  /// process information in control direction
+  kC_SC_NA_1 = 45,
+  kC_DC_NA_1 = 46,
+  kC_RC_NA_1 = 47,
+  kC_SE_NA_1 = 48,
+  kC_SE_NB_1 = 49,
+  kC_SE_NC_1 = 50,
+  kC_BO_NA_1 = 51,
+  kC_SC_TA_1 = 58,
+  kC_DC_TA_1 = 59,
+  kC_RC_TA_1 = 60,
+  kC_SE_TA_1 = 61,
+  kC_SE_TB_1 = 62,
+  kC_SE_TC_1 = 63,
+  kC_BO_TA_1 = 64,
+  /// system information in monitor direction
+  kM_EI_NA_1 = 70,
+  /// system information in control direction
+  kC_IC_NA_1 = 100,
+  kC_CI_NA_1 = 101,
+  kC_RD_NA_1 = 102,
+  kC_CS_NA_1 = 103,
+  kC_TS_NA_1 = 104,
+  kC_RP_NA_1 = 105,
+  kC_CD_NA_1 = 106,
+  kC_TS_TA_1 = 107,
+  /// parameter in control direction
+  kP_ME_NA_1 = 110,
+  kP_ME_NB_1 = 111,
+  kP_ME_NC_1 = 112,
+  kP_AC_NA_1 = 113,
+  /// file transfer
+  kF_FR_NA_1 = 120,
+  kF_SR_NA_1 = 121,
+  kF_SC_NA_1 = 122,
+  kF_LS_NA_1 = 123,
+  kF_AF_NA_1 = 124,
+  kF_SG_NA_1 = 125,
+  kF_DR_TA_1 = 126,
+  kF_SC_NB_1 = 127,
+};
+
+enum class TypeCategory : uint8_t {
+  kReserved,
+  kProcessMonitor,
+  kProcessControl,
+  kSystemMonitor,
+  kSystemControl,
+  kParameter,
+  kFileTransfer,
+  /// 128..135 message routing, 136..255 special use. the companion
+  /// standards, e.g. 102 integrated totals or 103 protection equipment,
+  /// define their types here, so the element layout is up to the profile
+  kPrivate,
+};
+
+enum class TimeTag : uint8_t { kNone = 0, kCP24Time2a = 3, kCP56Time2a = 7 };
+
+/**
+ * @brief where the quality bits of an element are
+ */
+enum class QualityLayout : uint8_t {
+  kNone,
+  /// SIQ/DIQ, bits 4..7 of the information octet
+  kInInformation,
+  /// a separate QDS octet
+  kQDS,
+  /// flags of the binary counter reading, SQ/CY/CA/IV
+  kBCR,
+  /// SEP, protection event state and quality in one octet
+  kSEP,
+  /// a separate QDP octet
+  kQDP,
+};
+
+/**
+ * @brief the layout of the information element of a type,
+ * elementSize does not include the information object address
+ */
+struct TypeDescriptor {
+  uint8_t typeId;
+  TypeCategory category;
+  uint8_t elementSize;
+  bool isVariableSize;
+  TimeTag timeTag;
+  QualityLayout quality;
+  /// offset of the quality octet in the element
+  uint8_t qualityOffset;
+  const char *name;
+
+  bool isKnown() const {
+    return category != TypeCategory::kReserved &&
+           category != TypeCategory::kPrivate;
+  }
+  /**
+   * @brief offset of the time tag, it always ends the element
+   *
+   * @return
+   */
+  constexpr size_t timeTagOffset() const {
+    return elementSize - static_cast<uint8_t>(timeTag);
+  }
+};
+
+namespace detail {
+template <typename Unused = void> struct TypeTable {
+  static constexpr TypeDescriptor kDescriptors[] = {
+      {0, TypeCategory::kReserved, 0, true, TimeTag::kNone,
+       QualityLayout::kNone, 0, "reserved"},
+      {128, TypeCategory::kPrivate, 0, true, TimeTag::kNone,
+       QualityLayout::kNone, 0, "private"},
+      {1, TypeCategory::kProcessMonitor, 1, false, TimeTag::kNone,
+       QualityLayout::kInInformation, 0, "M_SP_NA_1"},
+      {2, TypeCategory::kProcessMonitor, 4, false, TimeTag::kCP24Time2a,
+       QualityLayout::kInInformation, 0, "M_SP_TA_1"},
+      {3, TypeCategory::kProcessMonitor, 1, false, TimeTag::kNone,
+       QualityLayout::kInInformation, 0, "M_DP_NA_1"},
+      {4, TypeCategory::kProcessMonitor, 4, false, TimeTag::kCP24Time2a,
+       QualityLayout::kInInformation, 0, "M_DP_TA_1"},
+      {5, TypeCategory::kProcessMonitor, 2, false, TimeTag::kNone,
+       QualityLayout::kQDS, 1, "M_ST_NA_1"},
+      {6, TypeCategory::kProcessMonitor, 5, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDS, 1, "M_ST_TA_1"},
+      {7, TypeCategory::kProcessMonitor, 5, false, TimeTag::kNone,
+       QualityLayout::kQDS, 4, "M_BO_NA_1"},
+      {8, TypeCategory::kProcessMonitor, 8, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDS, 4, "M_BO_TA_1"},
+      {9, TypeCategory::kProcessMonitor, 3, false, TimeTag::kNone,
+       QualityLayout::kQDS, 2, "M_ME_NA_1"},
+      {10, TypeCategory::kProcessMonitor, 6, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDS, 2, "M_ME_TA_1"},
+      {11, TypeCategory::kProcessMonitor, 3, false, TimeTag::kNone,
+       QualityLayout::kQDS, 2, "M_ME_NB_1"},
+      {12, TypeCategory::kProcessMonitor, 6, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDS, 2, "M_ME_TB_1"},
+      {13, TypeCategory::kProcessMonitor, 5, false, TimeTag::kNone,
+       QualityLayout::kQDS, 4, "M_ME_NC_1"},
+      {14, TypeCategory::kProcessMonitor, 8, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDS, 4, "M_ME_TC_1"},
+      {15, TypeCategory::kProcessMonitor, 5, false, TimeTag::kNone,
+       QualityLayout::kBCR, 4, "M_IT_NA_1"},
+      {16, TypeCategory::kProcessMonitor, 8, false, TimeTag::kCP24Time2a,
+       QualityLayout::kBCR, 4, "M_IT_TA_1"},
+      {17, TypeCategory::kProcessMonitor, 6, false, TimeTag::kCP24Time2a,
+       QualityLayout::kSEP, 0, "M_EP_TA_1"},
+      {18, TypeCategory::kProcessMonitor, 7, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDP, 1, "M_EP_TB_1"},
+      {19, TypeCategory::kProcessMonitor, 7, false, TimeTag::kCP24Time2a,
+       QualityLayout::kQDP, 1, "M_EP_TC_1"},
+      {20, TypeCategory::kProcessMonitor, 5, false, TimeTag::kNone,
+       QualityLayout::kQDS, 4, "M_PS_NA_1"},
+      {21, TypeCategory::kProcessMonitor, 2, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "M_ME_ND_1"},
+      {30, TypeCategory::kProcessMonitor, 8, false, TimeTag::kCP56Time2a,
+       QualityLayout::kInInformation, 0, "M_SP_TB_1"},
+      {31, TypeCategory::kProcessMonitor, 8, false, TimeTag::kCP56Time2a,
+       QualityLayout::kInInformation, 0, "M_DP_TB_1"},
+      {32, TypeCategory::kProcessMonitor, 9, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDS, 1, "M_ST_TB_1"},
+      {33, TypeCategory::kProcessMonitor, 12, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDS, 4, "M_BO_TB_1"},
+      {34, TypeCategory::kProcessMonitor, 10, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDS, 2, "M_ME_TD_1"},
+      {35, TypeCategory::kProcessMonitor, 10, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDS, 2, "M_ME_TE_1"},
+      {36, TypeCategory::kProcessMonitor, 12, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDS, 4, "M_ME_TF_1"},
+      {37, TypeCategory::kProcessMonitor, 12, false, TimeTag::kCP56Time2a,
+       QualityLayout::kBCR, 4, "M_IT_TB_1"},
+      {38, TypeCategory::kProcessMonitor, 10, false, TimeTag::kCP56Time2a,
+       QualityLayout::kSEP, 0, "M_EP_TD_1"},
+      {39, TypeCategory::kProcessMonitor, 11, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDP, 1, "M_EP_TE_1"},
+      {40, TypeCategory::kProcessMonitor, 11, false, TimeTag::kCP56Time2a,
+       QualityLayout::kQDP, 1, "M_EP_TF_1"},
+      {45, TypeCategory::kProcessControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_SC_NA_1"},
+      {46, TypeCategory::kProcessControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_DC_NA_1"},
+      {47, TypeCategory::kProcessControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_RC_NA_1"},
+      {48, TypeCategory::kProcessControl, 3, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_SE_NA_1"},
+      {49, TypeCategory::kProcessControl, 3, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_SE_NB_1"},
+      {50, TypeCategory::kProcessControl, 5, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_SE_NC_1"},
+      {51, TypeCategory::kProcessControl, 4, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_BO_NA_1"},
+      {58, TypeCategory::kProcessControl, 8, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_SC_TA_1"},
+      {59, TypeCategory::kProcessControl, 8, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_DC_TA_1"},
+      {60, TypeCategory::kProcessControl, 8, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_RC_TA_1"},
+      {61, TypeCategory::kProcessControl, 10, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_SE_TA_1"},
+      {62, TypeCategory::kProcessControl, 10, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_SE_TB_1"},
+      {63, TypeCategory::kProcessControl, 12, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_SE_TC_1"},
+      {64, TypeCategory::kProcessControl, 11, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_BO_TA_1"},
+      {70, TypeCategory::kSystemMonitor, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "M_EI_NA_1"},
+      {100, TypeCategory::kSystemControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_IC_NA_1"},
+      {101, TypeCategory::kSystemControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_CI_NA_1"},
+      {102, TypeCategory::kSystemControl, 0, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_RD_NA_1"},
+      {103, TypeCategory::kSystemControl, 7, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_CS_NA_1"},
+      {104, TypeCategory::kSystemControl, 2, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_TS_NA_1"},
+      {105, TypeCategory::kSystemControl, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_RP_NA_1"},
+      {106, TypeCategory::kSystemControl, 2, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "C_CD_NA_1"},
+      {107, TypeCategory::kSystemControl, 9, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "C_TS_TA_1"},
+      {110, TypeCategory::kParameter, 3, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "P_ME_NA_1"},
+      {111, TypeCategory::kParameter, 3, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "P_ME_NB_1"},
+      {112, TypeCategory::kParameter, 5, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "P_ME_NC_1"},
+      {113, TypeCategory::kParameter, 1, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "P_AC_NA_1"},
+      {120, TypeCategory::kFileTransfer, 6, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_FR_NA_1"},
+      {121, TypeCategory::kFileTransfer, 7, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_SR_NA_1"},
+      {122, TypeCategory::kFileTransfer, 4, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_SC_NA_1"},
+      {123, TypeCategory::kFileTransfer, 5, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_LS_NA_1"},
+      {124, TypeCategory::kFileTransfer, 4, false, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_AF_NA_1"},
+      /// NOF, NOS, LOS and a segment of LOS octets
+      {125, TypeCategory::kFileTransfer, 4, true, TimeTag::kNone,
+       QualityLayout::kNone, 0, "F_SG_NA_1"},
+      {126, TypeCategory::kFileTransfer, 13, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "F_DR_TA_1"},
+      {127, TypeCategory::kFileTransfer, 16, false, TimeTag::kCP56Time2a,
+       QualityLayout::kNone, 0, "F_SC_NB_1"},
+  };
+  static constexpr size_t kCount =
+      sizeof(kDescriptors) / sizeof(kDescriptors[0]);
+
+  /**
+   * @brief table index of a type id, 0 for reserved, 1 for private
+   */
+  static constexpr size_t indexOf(uint8_t id, size_t i = 2) {
+    return id >= 128  ? 1
+           : i == kCount ? 0
+           : kDescriptors[i].typeId == id ? i
+                                          : indexOf(id, i + 1);
+  }
+};
+template <typename Unused>
+constexpr TypeDescriptor TypeTable<Unused>::kDescriptors[];
+
+/**
+ * @brief table index of every type id, so a lookup is a single load
+ */
+template <typename Sequence> struct TypeIndex;
+template <size_t... I> struct TypeIndex<IndexSequence<I...>> {
+  static constexpr uint8_t kIndex[] = {
+      static_cast<uint8_t>(TypeTable<>::indexOf(I))...};
+};
+template <size_t... I>
+constexpr uint8_t TypeIndex<IndexSequence<I...>>::kIndex[];
+
+typedef TypeIndex<MakeIndexSequence<256>::type> TypeIndex256;
+} // namespace detail
+
+/**
+ * @brief the layout of a type id, reserved and private type ids have
+ * category kReserved/kPrivate and a variable size
+ *
+ * @param id
+ * @return
+ */
+constexpr const TypeDescriptor &typeDescriptor(uint8_t id) {
+  return detail::TypeTable<>::kDescriptors[detail::TypeIndex256::kIndex[id]];
+}
+
+constexpr const TypeDescriptor &typeDescriptor(TypeId id) {
+  return typeDescriptor(static_cast<uint8_t>(id));
+}
+
+} // namespace asdu
+} // namespace QIEC60870
+
+#endif
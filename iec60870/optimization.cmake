@@ -0,0 +1,55 @@
+## optimization settings for the tests and benchmarks of this tree, the
+## libraries are header only, so the flags are usage requirements of
+## qiec60870::optimization. they are BUILD_INTERFACE only, the installed
+## target is empty and consumers choose LTO, -march and PGO themselves
+option(QIEC60870_ENABLE_LTO "link time optimization" OFF)
+set(QIEC60870_MARCH "" CACHE STRING "target architecture passed to -march, e.g. native")
+set(QIEC60870_PGO "OFF" CACHE STRING "profile guided optimization: OFF, GENERATE or USE")
+set_property(CACHE QIEC60870_PGO PROPERTY STRINGS OFF GENERATE USE)
+set(QIEC60870_PGO_DIR "${CMAKE_BINARY_DIR}/pgo" CACHE PATH "profile directory for QIEC60870_PGO")
+
+add_library(qiec60870_optimization INTERFACE)
+add_library(qiec60870::optimization ALIAS qiec60870_optimization)
+set_target_properties(qiec60870_optimization PROPERTIES EXPORT_NAME optimization)
+install(TARGETS qiec60870_optimization EXPORT qiec60870Targets)
+
+if(QIEC60870_ENABLE_LTO)
+  include(CheckIPOSupported)
+  check_ipo_supported(RESULT QIEC60870_LTO_SUPPORTED OUTPUT QIEC60870_LTO_ERROR)
+  if(NOT QIEC60870_LTO_SUPPORTED)
+    message(WARNING "link time optimization is not supported: ${QIEC60870_LTO_ERROR}")
+  elseif(MSVC)
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:/GL>)
+    target_link_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:/LTCG>)
+  else()
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-flto>)
+    target_link_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-flto>)
+  endif()
+endif()
+
+if(QIEC60870_MARCH)
+  if(MSVC)
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:/arch:${QIEC60870_MARCH}>)
+  else()
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-march=${QIEC60870_MARCH}>)
+  endif()
+endif()
+
+if(NOT QIEC60870_PGO STREQUAL "OFF")
+  if(MSVC)
+    message(WARNING "QIEC60870_PGO is only supported with GCC and Clang")
+  elseif(QIEC60870_PGO STREQUAL "GENERATE")
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-fprofile-generate=${QIEC60870_PGO_DIR}>)
+    target_link_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-fprofile-generate=${QIEC60870_PGO_DIR}>)
+  elseif(QIEC60870_PGO STREQUAL "USE")
+    ## clang reads <dir>/default.profdata, merge the raw profiles first
+    target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-fprofile-use=${QIEC60870_PGO_DIR}>)
+    if(CMAKE_CXX_COMPILER_ID STREQUAL "GNU")
+      target_compile_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-fprofile-correction>
+        $<BUILD_INTERFACE:-Wno-missing-profile>)
+    endif()
+    target_link_options(qiec60870_optimization INTERFACE $<BUILD_INTERFACE:-fprofile-use=${QIEC60870_PGO_DIR}>)
+  else()
+    message(FATAL_ERROR "QIEC60870_PGO must be OFF, GENERATE or USE")
+  endif()
+endif()
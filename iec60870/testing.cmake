@@ -0,0 +1,49 @@
+## the unit test and benchmark executables of this tree. googletest is built
+## in thrd/, google-benchmark too when its archive is there, otherwise an
+## installed package is used and without one the benchmarks are not built,
+## with a warning
+if(QIEC60870_BUILD_BENCH AND NOT TARGET googlebenchmark)
+	find_package(benchmark QUIET)
+	if(NOT benchmark_FOUND)
+		message(WARNING "QIEC60870_BUILD_BENCH is ON, but neither "
+			"thrd/benchmark-1.7.1.tar.gz nor an installed google-benchmark was "
+			"found, the benchmarks are not built")
+	endif()
+endif()
+
+## qiec60870_add_test(name sources...)
+## a googletest executable registered with ctest, link the libraries it
+## tests with target_link_libraries(name ...)
+function(qiec60870_add_test name)
+	add_executable(${name} ${ARGN})
+	target_include_directories(${name} PRIVATE ${IEC60870_BUILD_ROOT}/thrd/googletest/include)
+	target_link_directories(${name} PRIVATE ${IEC60870_BUILD_ROOT}/thrd/googletest/lib)
+	target_link_libraries(${name} debug gtest_maind optimized gtest_main)
+	target_link_libraries(${name} debug gmock_maind optimized gmock_main)
+	target_link_libraries(${name} debug gmockd optimized gmock)
+	target_link_libraries(${name} debug gtestd optimized gtest)
+	if(NOT WIN32)
+		target_link_libraries(${name} pthread)
+	endif()
+	add_dependencies(${name} googletest)
+	add_test(NAME ${name} COMMAND ${name})
+endfunction()
+
+## qiec60870_add_benchmark(name sources...)
+## a google-benchmark executable, not created without google-benchmark, so
+## anything more goes in if(TARGET name)
+function(qiec60870_add_benchmark name)
+	if(TARGET googlebenchmark)
+		add_executable(${name} ${ARGN})
+		target_include_directories(${name} PRIVATE ${IEC60870_BUILD_ROOT}/thrd/googlebenchmark/include)
+		target_link_directories(${name} PRIVATE ${IEC60870_BUILD_ROOT}/thrd/googlebenchmark/lib)
+		target_link_libraries(${name} benchmark_main benchmark)
+		if(NOT WIN32)
+			target_link_libraries(${name} pthread)
+		endif()
+		add_dependencies(${name} googlebenchmark)
+	elseif(TARGET benchmark::benchmark)
+		add_executable(${name} ${ARGN})
+		target_link_libraries(${name} benchmark::benchmark_main benchmark::benchmark)
+	endif()
+endfunction()
@@ -0,0 +1,19 @@
+## google-benchmark is built from thrd/benchmark-1.7.1.tar.gz when the archive
+## is present, otherwise the benchmarks fall back to an installed package,
+## see iec60870/testing.cmake. without either they are not built, with a
+## warning
+set(BENCHMARK_ARCHIVE ${CMAKE_CURRENT_SOURCE_DIR}/benchmark-1.7.1.tar.gz)
+if(EXISTS ${BENCHMARK_ARCHIVE})
+	include(ExternalProject)
+
+	ExternalProject_Add(googlebenchmark
+			URL             ${BENCHMARK_ARCHIVE}
+			PREFIX googlebenchmark
+			CMAKE_ARGS
+							-DCMAKE_BUILD_TYPE=Release
+							-DCMAKE_INSTALL_PREFIX=<INSTALL_DIR>
+							-DBENCHMARK_ENABLE_TESTING=OFF
+							-DBENCHMARK_ENABLE_GTEST_TESTS=OFF
+	)
+	set_target_properties(googlebenchmark PROPERTIES FOLDER "googlebenchmark")
+endif()
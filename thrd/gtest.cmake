@@ -6,5 +6,6 @@ ExternalProject_Add(googletest
 		CMAKE_ARGS
 						-Dgtest_force_shared_crt=ON
 						-DCMAKE_INSTALL_PREFIX=<INSTALL_DIR>
+						-DCMAKE_CXX_FLAGS=-Wno-maybe-uninitialized
 )
 set_target_properties(googletest PROPERTIES FOLDER "googletest")